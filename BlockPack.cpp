@@ -0,0 +1,235 @@
+#include "BlockPack.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include "Crc32.hpp"
+
+constexpr const size_t RECORD_SIZE = 52;
+constexpr const size_t MASK_OFFSET = 41;
+constexpr const uint16_t AllDigits = 0x3FE;
+
+static uint32_t readU32(const unsigned char* data) {
+    return
+        static_cast<uint32_t>(data[0]) |
+        (static_cast<uint32_t>(data[1]) << 8) |
+        (static_cast<uint32_t>(data[2]) << 16) |
+        (static_cast<uint32_t>(data[3]) << 24);
+}
+
+static int boxOf(int cell) {
+    return cell / 27 * 3 + cell % 9 / 3;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char>& out) : out(out) {}
+    ~BitWriter() {
+        if (available != 0) {
+            out.push_back(static_cast<unsigned char>(buffer));
+        }
+    }
+
+    void write(uint32_t value, int bits) {
+        buffer |= static_cast<uint64_t>(value) << available;
+        available += bits;
+        for (; available >= 8; available -= 8) {
+            out.push_back(static_cast<unsigned char>(buffer));
+            buffer >>= 8;
+        }
+    }
+
+private:
+    std::vector<unsigned char>& out;
+    uint64_t buffer = 0;
+    int available = 0;
+};
+
+// Reads zeros past the end, overrun() tells whether it got there.
+class BitReader {
+public:
+    BitReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+
+    // The next `bits`, up to 32, without taking them.
+    uint32_t peek(int bits) {
+        for (; available < 32; available += 8) {
+            buffer |= static_cast<uint64_t>(position < size ? data[position] : 0) << available;
+            ++position;
+        }
+        return static_cast<uint32_t>(buffer & ((1ull << bits) - 1));
+    }
+
+    void skip(int bits) {
+        buffer >>= bits;
+        available -= bits;
+    }
+
+    uint32_t read(int bits) {
+        const uint32_t value = peek(bits);
+        skip(bits);
+        return value;
+    }
+
+    bool overrun() const { return position * 8 - available > size * 8; }
+
+private:
+    const unsigned char* data;
+    const size_t size;
+    size_t position = 0;
+    uint64_t buffer = 0;
+    int available = 0;
+};
+
+// Per nine bit mask of allowed digits (bit 0 for digit 1): how many there
+// are, and each one in order.
+struct Choices {
+    uint8_t count;
+    std::array<uint8_t, 9> digits;
+};
+
+constexpr auto ChoiceTable = [] {
+    std::array<Choices, 512> table = {};
+    for (int allowed = 0; allowed < 512; ++allowed) {
+        for (int digit = 1; digit <= 9; ++digit) {
+            if (allowed & (1 << (digit - 1))) {
+                table[allowed].digits[table[allowed].count++] = static_cast<uint8_t>(digit);
+            }
+        }
+    }
+    return table;
+}();
+
+// Truncated binary for `value` < `choices`: the short codes come first,
+// and the long ones put their extra bit last so a reader knows from the
+// short part whether to read it.
+static void writeChoice(BitWriter& writer, uint32_t value, uint32_t choices) {
+    if (choices < 2) {
+        return;
+    }
+    const int bits = std::bit_width(choices) - 1;
+    const uint32_t shorter = (2u << bits) - choices;
+    if (value < shorter) {
+        writer.write(value, bits);
+    } else {
+        writer.write((value + shorter) >> 1, bits);
+        writer.write((value + shorter) & 1, 1);
+    }
+}
+
+static uint32_t readChoice(BitReader& reader, uint32_t choices) {
+    if (choices < 2) {
+        return 0;
+    }
+    const int bits = std::bit_width(choices) - 1;
+    const uint32_t shorter = (2u << bits) - choices;
+    // the long codes' extra bit is right behind the short part
+    const uint32_t both = reader.peek(bits + 1);
+    const uint32_t value = both & ((1u << bits) - 1);
+    const bool longer = value >= shorter;
+    reader.skip(bits + longer);
+    return longer ? (value << 1 | both >> bits) - shorter : value;
+}
+
+bool BlockPack::compress(const unsigned char* records, size_t count, std::vector<unsigned char>& out) {
+    BitWriter writer(out);
+    for (size_t n = 0; n < count; ++n) {
+        const unsigned char* record = records + n * RECORD_SIZE;
+        uint16_t rows[9] = {}, columns[9] = {}, boxes[9] = {};
+        for (int cell = 0; cell < 81; ++cell) {
+            const int digit = cell % 2 == 0 ? record[cell / 2] >> 4 : record[cell / 2] & 0x0F;
+            const int row = cell / 9, column = cell % 9, box = boxOf(cell);
+            const uint16_t allowed = AllDigits & ~(rows[row] | columns[column] | boxes[box]);
+            if (!(allowed & (1 << digit))) {
+                return false;
+            }
+            writeChoice(writer,
+                std::popcount(static_cast<uint16_t>(allowed & ((1 << digit) - 1))),
+                std::popcount(allowed));
+            rows[row] |= 1 << digit;
+            columns[column] |= 1 << digit;
+            boxes[box] |= 1 << digit;
+        }
+        for (int cell = 0; cell < 81; ++cell) {
+            writer.write((record[MASK_OFFSET + cell / 8] >> (cell % 8)) & 1, 1);
+        }
+    }
+    return true;
+}
+
+bool BlockPack::decompress(const unsigned char* data, size_t size, size_t count, unsigned char* records) {
+    BitReader reader(data, size);
+    for (size_t n = 0; n < count; ++n) {
+        unsigned char* record = records + n * RECORD_SIZE;
+        std::memset(record, 0, RECORD_SIZE);
+        uint16_t rows[9] = {}, columns[9] = {}, boxes[9] = {};
+        for (int cell = 0; cell < 81; ++cell) {
+            const int row = cell / 9, column = cell % 9, box = boxOf(cell);
+            const Choices& choices = ChoiceTable[(AllDigits & ~(rows[row] | columns[column] | boxes[box])) >> 1];
+            const uint32_t choice = readChoice(reader, choices.count);
+            if (choice >= choices.count) {
+                return false;
+            }
+            const int digit = choices.digits[choice];
+
+            record[cell / 2] |= cell % 2 == 0 ? digit << 4 : digit;
+            rows[row] |= 1 << digit;
+            columns[column] |= 1 << digit;
+            boxes[box] |= 1 << digit;
+        }
+
+        const uint32_t mask[3] = { reader.read(32), reader.read(32), reader.read(17) };
+        for (int byte = 0; byte < 11; ++byte) {
+            record[MASK_OFFSET + byte] = static_cast<unsigned char>(mask[byte / 4] >> (byte % 4 * 8));
+        }
+    }
+    return !reader.overrun();
+}
+
+bool BlockCache::read(const BlockPack& pack, uint32_t index, unsigned char* record) {
+    if (index >= pack.count) {
+        return false;
+    }
+    const uint32_t block = index / pack.perBlock;
+    const size_t offset = static_cast<size_t>(index % pack.perBlock) * RECORD_SIZE;
+
+    std::lock_guard guard(lock);
+    ++clock;
+    for (auto& entry : entries) {
+        if (entry.blocks == pack.blocks && entry.block == block) {
+            entry.used = clock;
+            ++hitCount;
+            std::memcpy(record, entry.records.data() + offset, RECORD_SIZE);
+            return true;
+        }
+    }
+
+    ++missCount;
+    const uint32_t begin = readU32(pack.offsets + block * 4);
+    const uint32_t end = readU32(pack.offsets + block * 4 + 4);
+    if (begin > end || end > readU32(pack.offsets + pack.blockCount() * 4)
+        || crc32(pack.blocks + begin, end - begin) != readU32(pack.checksums + block * 4)) {
+        return false;
+    }
+
+    Entry* entry;
+    if (entries.size() < capacity) {
+        entry = &entries.emplace_back();
+    } else {
+        entry = &*std::min_element(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    }
+
+    entry->records.resize(static_cast<size_t>(pack.blockSize(block)) * RECORD_SIZE);
+    if (!BlockPack::decompress(pack.blocks + begin, end - begin, pack.blockSize(block), entry->records.data())) {
+        // not worth keeping
+        entry->blocks = nullptr;
+        entry->used = 0;
+        return false;
+    }
+    entry->blocks = pack.blocks;
+    entry->block = block;
+    entry->used = clock;
+    std::memcpy(record, entry->records.data() + offset, RECORD_SIZE);
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// The records of a SUDOKU02 pack: 52 byte records (see res/README.md)
+// compressed in blocks of `perBlock` that each decode on their own.
+//
+// A compressed record is a little endian bit stream. Each solution cell
+// in order is the index of its digit among the digits its row, column
+// and box still allow, in truncated binary, so forced cells take no bits
+// at all. Then come the 81 mask bits. Records follow each other without
+// padding, a block is padded to a whole byte. About 21 bytes a record.
+struct BlockPack {
+    // blockCount() + 1 u32 offsets into `blocks`, the last being its size
+    const unsigned char* offsets;
+    // blockCount() u32 crc32s, one per block
+    const unsigned char* checksums;
+    const unsigned char* blocks;
+    uint32_t count;
+    uint32_t perBlock;
+
+    constexpr uint32_t blockCount() const { return static_cast<uint32_t>((static_cast<uint64_t>(count) + perBlock - 1) / perBlock); }
+    constexpr uint32_t blockSize(uint32_t block) const { return std::min(perBlock, count - block * perBlock); }
+
+    // Appends `count` records compressed as one block, false if one of
+    // them isn't a solved grid.
+    static bool compress(const unsigned char* records, size_t count, std::vector<unsigned char>& out);
+    // False if `data` doesn't hold `count` records.
+    static bool decompress(const unsigned char* data, size_t size, size_t count, unsigned char* records);
+};
+
+// Decoded blocks of any number of packs, the least recently used one
+// makes room for the next.
+class BlockCache {
+public:
+    explicit BlockCache(size_t capacity = 8) : capacity(capacity) {}
+
+    // Copies record `index` of `pack` into the 52 bytes at `record`,
+    // decoding its block first unless it's cached. False if the block
+    // doesn't match its checksum or doesn't decode.
+    bool read(const BlockPack& pack, uint32_t index, unsigned char* record);
+
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+
+private:
+    struct Entry {
+        const unsigned char* blocks;
+        uint32_t block;
+        uint64_t used;
+        std::vector<unsigned char> records;
+    };
+
+    std::mutex lock;
+    std::vector<Entry> entries;
+    const size_t capacity;
+    uint64_t clock = 0;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+};
@@ -0,0 +1,112 @@
+#include "BoardState.hpp"
+
+// The row, column and box unit of every cell.
+constexpr auto generateCellUnits() {
+    std::array<std::array<uint8_t, 3>, 81> units{};
+    for (size_t i = 0; i < 81; ++i) {
+        units[i] = {
+            static_cast<uint8_t>(i / 9),
+            static_cast<uint8_t>(9 + i % 9),
+            static_cast<uint8_t>(18 + (i / 27) * 3 + (i % 9) / 3)};
+    }
+    return units;
+}
+
+constexpr auto CellUnits = generateCellUnits();
+
+void BoardState::reset(const Sudoku& sudoku) {
+    this->sudoku = sudoku;
+    cells = {};
+    counts = {};
+    occupied = {};
+    duplicates = 0;
+    wrong = 0;
+    filled = 0;
+
+    for (int cell = 0; cell < 81; ++cell) {
+        if (sudoku.HintMask[cell]) {
+            add(cell, sudoku.Number[cell]);
+        }
+    }
+}
+
+BoardState::Placement BoardState::place(int cell, int digit) {
+    if (sudoku.HintMask[cell]) {
+        return Placement::Rejected;
+    }
+
+    if (cells[cell] != digit) {
+        remove(cell);
+        add(cell, digit);
+    }
+
+    if (hasConflict(cell)) {
+        return Placement::Conflict;
+    }
+    if (digit != sudoku.Number[cell]) {
+        return Placement::Wrong;
+    }
+    return solved() ? Placement::Solved : Placement::Correct;
+}
+
+bool BoardState::clear(int cell) {
+    if (sudoku.HintMask[cell] || cells[cell] == 0) {
+        return false;
+    }
+    remove(cell);
+    return true;
+}
+
+bool BoardState::hasConflict(int cell) const {
+    const int digit = cells[cell];
+    if (digit == 0) {
+        return false;
+    }
+    for (const auto unit : CellUnits[cell]) {
+        if (counts[unit][digit - 1] > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t BoardState::candidates(int cell) const {
+    const auto& units = CellUnits[cell];
+    return ~(occupied[units[0]] | occupied[units[1]] | occupied[units[2]]) & 0x1FF;
+}
+
+void BoardState::add(int cell, int digit) {
+    cells[cell] = static_cast<uint8_t>(digit);
+    ++filled;
+    if (digit != sudoku.Number[cell]) {
+        ++wrong;
+    }
+
+    for (const auto unit : CellUnits[cell]) {
+        if (counts[unit][digit - 1]++ > 0) {
+            ++duplicates;
+        }
+        occupied[unit] |= 1 << (digit - 1);
+    }
+}
+
+void BoardState::remove(int cell) {
+    const int digit = cells[cell];
+    if (digit == 0) {
+        return;
+    }
+
+    cells[cell] = 0;
+    --filled;
+    if (digit != sudoku.Number[cell]) {
+        --wrong;
+    }
+
+    for (const auto unit : CellUnits[cell]) {
+        if (--counts[unit][digit - 1] > 0) {
+            --duplicates;
+        } else {
+            occupied[unit] &= ~(1 << (digit - 1));
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Sudoku.hpp"
+
+// The digits written so far on top of a puzzle's givens. Every row,
+// column and box keeps per-digit counts plus an occupancy bitmask, so
+// each edit and each conflict check is constant time.
+class BoardState {
+public:
+    enum class Placement {
+        Correct,
+        // matches no other digit in its units, but not the solution
+        Wrong,
+        // the digit already is in the cell's row, column or box
+        Conflict,
+        // correct, and the board is now complete
+        Solved,
+        // givens can't be written over
+        Rejected
+    };
+
+    BoardState() = default;
+    explicit BoardState(const Sudoku& sudoku) { reset(sudoku); }
+
+    // Starts over with only the givens of `sudoku`.
+    void reset(const Sudoku& sudoku);
+
+    // Writes `digit` (1-9) into `cell`, replacing what was written there.
+    Placement place(int cell, int digit);
+    // Returns false for givens and empty cells.
+    bool clear(int cell);
+
+    // 0 for an empty cell.
+    int digit(int cell) const { return cells[cell]; }
+    bool isGiven(int cell) const { return sudoku.HintMask[cell]; }
+    // Whether the digit in `cell` also appears elsewhere in one of its units.
+    bool hasConflict(int cell) const;
+    // Digits that can still go into `cell` without a conflict, bit 0 for 1.
+    uint16_t candidates(int cell) const;
+
+    // Digits that duplicate another in the same unit, counted per unit.
+    int conflictCount() const { return duplicates; }
+    int wrongCount() const { return wrong; }
+    int filledCount() const { return filled; }
+    bool solved() const { return filled == 81 && wrong == 0; }
+
+private:
+    void add(int cell, int digit);
+    void remove(int cell);
+
+    Sudoku sudoku{};
+    std::array<uint8_t, 81> cells{};
+
+    // rows, then columns, then boxes
+    std::array<std::array<uint8_t, 9>, 27> counts{};
+    std::array<uint16_t, 27> occupied{};
+
+    int duplicates = 0;
+    int wrong = 0;
+    int filled = 0;
+};
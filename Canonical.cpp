@@ -0,0 +1,457 @@
+#include "Canonical.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+// The six orders of three columns, indexed by an order state / 4.
+constexpr std::array<std::array<uint8_t, 3>, 6> Permutations = {{
+    { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 },
+}};
+
+// Per order of three, how far left each source entry's three bits go to
+// land in its place, the first place being the highest.
+constexpr auto Shifts = [] {
+    std::array<std::array<uint8_t, 3>, 6> shifts = {};
+    for (int permutation = 0; permutation < 6; ++permutation) {
+        for (int place = 0; place < 3; ++place) {
+            shifts[permutation][Permutations[permutation][place]] = static_cast<uint8_t>(6 - place * 3);
+        }
+    }
+    return shifts;
+}();
+
+// Columns (of the possibly transposed grid) still free to be reordered.
+// Orders of three are kept as a state: the index into `Permutations` times
+// four, plus split bits where a set bit k ends a group of interchangeable
+// entries after position k. `stacks` orders the stacks, `columns[s]` the
+// columns within source stack s.
+struct ColumnOrder {
+    uint8_t stacks;
+    std::array<uint8_t, 3> columns;
+};
+
+constexpr ColumnOrder Unordered = { 0, { 0, 0, 0 } };
+
+static constexpr int permutationIndex(const std::array<uint8_t, 3>& order) {
+    int permutation = 0;
+    while (Permutations[permutation] != order) {
+        ++permutation;
+    }
+    return permutation;
+}
+
+// Calls `visit(begin, end)` for each group of positions [begin, end) of a
+// three element order split by `splits`.
+template <typename Visit>
+static constexpr void forGroups(uint8_t splits, Visit visit) {
+    int begin = 0;
+    for (int position = 0; position < 3; ++position) {
+        if (position == 2 || (splits & (1 << position))) {
+            visit(begin, position + 1);
+            begin = position + 1;
+        }
+    }
+}
+
+struct ColumnStep {
+    uint8_t state;
+    uint8_t pattern;
+};
+
+// Per column state and three bit clue mask of a row: the state after
+// moving empty cells before clues within each group, keeping the order
+// otherwise, and the pattern that leaves, first column in the high bit.
+constexpr auto ColumnSteps = [] {
+    std::array<std::array<ColumnStep, 8>, 24> steps = {};
+    for (int state = 0; state < 24; ++state) {
+        for (int mask = 0; mask < 8; ++mask) {
+            std::array<uint8_t, 3> columns = Permutations[state / 4];
+            uint8_t splits = state % 4;
+            uint8_t pattern = 0;
+            forGroups(splits, [&](int begin, int end) {
+                std::array<uint8_t, 3> clues = {};
+                int clueCount = 0, next = begin;
+                for (int i = begin; i < end; ++i) {
+                    if (mask & (1 << columns[i])) {
+                        clues[clueCount++] = columns[i];
+                    } else {
+                        columns[next++] = columns[i];
+                    }
+                }
+                for (int i = 0; i < clueCount; ++i) {
+                    columns[next + i] = clues[i];
+                    pattern |= 1 << (2 - next - i);
+                }
+                if (clueCount != 0 && next != begin) {
+                    splits |= 1 << (next - 1);
+                }
+            });
+
+            steps[state][mask] = { static_cast<uint8_t>(permutationIndex(columns) * 4 + splits), pattern };
+        }
+    }
+    return steps;
+}();
+
+// How three stack patterns compare, each pair as 0 for less, 1 for equal
+// and 2 for greater, pairs (0, 1), (0, 2) and (1, 2) in base three.
+static constexpr int comparison(int first, int second, int third) {
+    auto compare = [](int a, int b) { return (a > b) - (a < b) + 1; };
+    return compare(first, second) * 9 + compare(first, third) * 3 + compare(second, third);
+}
+
+// Per stack state and comparison: the state after sorting each group of
+// stacks by pattern, stable, and splitting it where patterns differ.
+constexpr auto StackSteps = [] {
+    std::array<std::array<uint8_t, 27>, 24> steps = {};
+    for (int state = 0; state < 24; ++state) {
+        for (int code = 0; code < 27; ++code) {
+            // any patterns ordered as `code` says will do
+            const int relation[3][3] = {
+                { 1, code / 9, code / 3 % 3 },
+                { 2 - code / 9, 1, code % 3 },
+                { 2 - code / 3 % 3, 2 - code % 3, 1 },
+            };
+            auto less = [&](int a, int b) { return relation[a][b] == 0; };
+
+            std::array<uint8_t, 3> stacks = Permutations[state / 4];
+            uint8_t splits = state % 4;
+            forGroups(splits, [&](int begin, int end) {
+                for (int i = begin + 1; i < end; ++i) {
+                    for (int j = i; j > begin && less(stacks[j], stacks[j - 1]); --j) {
+                        std::swap(stacks[j], stacks[j - 1]);
+                    }
+                }
+                for (int i = begin; i + 1 < end; ++i) {
+                    if (relation[stacks[i]][stacks[i + 1]] != 1) {
+                        splits |= 1 << i;
+                    }
+                }
+            });
+            steps[state][code] = static_cast<uint8_t>(permutationIndex(stacks) * 4 + splits);
+        }
+    }
+    return steps;
+}();
+
+// Reorders `order` as far as `row` (a clue bitmask over source columns)
+// asks for: empty cells first, then clues. Returns the smallest row
+// pattern that allows, the first column in the highest of nine bits.
+static constexpr uint16_t refine(ColumnOrder& order, uint16_t row) {
+    const ColumnStep first = ColumnSteps[order.columns[0]][row & 7];
+    const ColumnStep second = ColumnSteps[order.columns[1]][row >> 3 & 7];
+    const ColumnStep third = ColumnSteps[order.columns[2]][row >> 6 & 7];
+    order.columns = { first.state, second.state, third.state };
+
+    order.stacks = StackSteps[order.stacks][comparison(first.pattern, second.pattern, third.pattern)];
+    const auto& shifts = Shifts[order.stacks / 4];
+    return static_cast<uint16_t>(first.pattern << shifts[0] | second.pattern << shifts[1] | third.pattern << shifts[2]);
+}
+
+// With nothing ordered yet a row's value only depends on its clue mask.
+constexpr auto FirstRowValues = [] {
+    std::array<uint16_t, 512> values = {};
+    for (int row = 0; row < 512; ++row) {
+        ColumnOrder order = Unordered;
+        values[row] = refine(order, static_cast<uint16_t>(row));
+    }
+    return values;
+}();
+
+// Rows placed so far, of the grid or its transpose, and the column orders
+// they still allow.
+struct Path {
+    bool transposed;
+    std::array<uint8_t, 9> rows;
+    ColumnOrder columns;
+    uint16_t usedRows;
+};
+
+// Places rows one at a time on every path that's still smallest, keeping
+// those that stay smallest. Ties are followed side by side, so one that
+// falls behind stops costing anything right away. Leaves the paths that
+// place all rows, and the clue pattern they share as nine rows.
+static void findSmallest(
+    const std::array<std::array<uint16_t, 9>, 2>& masks,
+    std::vector<Path>& paths,
+    std::array<uint16_t, 9>& pattern) {
+    thread_local std::vector<Path> next;
+
+    // with nothing ordered yet the table rules out most first rows
+    uint16_t first = UINT16_MAX;
+    for (const auto& sourceRows : masks) {
+        for (const uint16_t row : sourceRows) {
+            first = std::min(first, FirstRowValues[row]);
+        }
+    }
+    paths.clear();
+    for (int transposed = 0; transposed < 2; ++transposed) {
+        for (int row = 0; row < 9; ++row) {
+            if (FirstRowValues[masks[transposed][row]] == first) {
+                Path path = { transposed != 0, {}, Unordered, static_cast<uint16_t>(1 << row) };
+                path.rows[0] = static_cast<uint8_t>(row);
+                refine(path.columns, masks[transposed][row]);
+                paths.push_back(path);
+            }
+        }
+    }
+    pattern[0] = first;
+
+    for (int depth = 1; depth < 9; ++depth) {
+        next.clear();
+        uint16_t smallest = UINT16_MAX;
+        for (const Path& path : paths) {
+            // any row of an unused band, or the rest of the current one
+            const int band = path.rows[depth - 1] / 3;
+            const uint16_t allowed = depth % 3 == 0 ? 0x1FF : 7 << (band * 3);
+            for (uint16_t open = allowed & ~path.usedRows; open != 0; open &= open - 1) {
+                const int row = std::countr_zero(open);
+                ColumnOrder columns = path.columns;
+                const uint16_t value = refine(columns, masks[path.transposed][row]);
+                if (value > smallest) {
+                    continue;
+                }
+                if (value < smallest) {
+                    smallest = value;
+                    next.clear();
+                }
+                Path& extended = next.emplace_back(path);
+                extended.rows[depth] = static_cast<uint8_t>(row);
+                extended.columns = columns;
+                extended.usedRows |= 1 << row;
+            }
+        }
+        pattern[depth] = smallest;
+        paths.swap(next);
+    }
+}
+
+// Every column order `order` still allows, as target column -> source column.
+template <typename Visit>
+static void forColumnOrders(const ColumnOrder& order, Visit visit) {
+    // enumerate the permutations of each group in turn
+    std::array<uint8_t, 3> stacks = Permutations[order.stacks / 4];
+    std::array<std::array<uint8_t, 3>, 3> columns;
+    for (int stack = 0; stack < 3; ++stack) {
+        for (int i = 0; i < 3; ++i) {
+            columns[stack][i] = static_cast<uint8_t>(stack * 3 + Permutations[order.columns[stack] / 4][i]);
+        }
+    }
+
+    // one order is all that's left for most puzzles
+    if ((order.stacks & order.columns[0] & order.columns[1] & order.columns[2] & 3) == 3) {
+        std::array<uint8_t, 9> result;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                result[i * 3 + j] = columns[stacks[i]][j];
+            }
+        }
+        visit(result);
+        return;
+    }
+
+    auto permuteColumns = [&](auto& self, int stack) -> void {
+        if (stack == 3) {
+            std::array<uint8_t, 9> result;
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    result[i * 3 + j] = columns[stacks[i]][j];
+                }
+            }
+            visit(result);
+            return;
+        }
+        // all orders of all groups of this stack, via the groups' own permutations
+        auto& cells = columns[stack];
+        std::array<std::pair<int, int>, 3> groups;
+        int groupCount = 0;
+        forGroups(order.columns[stack] % 4, [&](int begin, int end) {
+            groups[groupCount++] = { begin, end };
+            std::sort(cells.begin() + begin, cells.begin() + end);
+        });
+        auto permuteGroup = [&](auto& next, int group) -> void {
+            if (group == groupCount) {
+                self(self, stack + 1);
+                return;
+            }
+            const auto [begin, end] = groups[group];
+            do {
+                next(next, group + 1);
+            } while (std::next_permutation(cells.begin() + begin, cells.begin() + end));
+        };
+        permuteGroup(permuteGroup, 0);
+    };
+
+    std::array<std::pair<int, int>, 3> groups;
+    int groupCount = 0;
+    forGroups(order.stacks % 4, [&](int begin, int end) {
+        groups[groupCount++] = { begin, end };
+        std::sort(stacks.begin() + begin, stacks.begin() + end);
+    });
+    auto permuteStacks = [&](auto& next, int group) -> void {
+        if (group == groupCount) {
+            permuteColumns(permuteColumns, 0);
+            return;
+        }
+        const auto [begin, end] = groups[group];
+        do {
+            next(next, group + 1);
+        } while (std::next_permutation(stacks.begin() + begin, stacks.begin() + end));
+    };
+    permuteStacks(permuteStacks, 0);
+}
+
+Sudoku Canonical::form(const Sudoku& sudoku) {
+    // clue bitmasks per source row, of the grid and its transpose
+    std::array<std::array<uint16_t, 9>, 2> masks = {};
+    for (int row = 0; row < 9; ++row) {
+        for (int column = 0; column < 9; ++column) {
+            masks[0][row] |= sudoku.HintMask[row * 9 + column] << column;
+            masks[1][column] |= sudoku.HintMask[row * 9 + column] << row;
+        }
+    }
+    thread_local std::vector<Path> leaves;
+    std::array<uint16_t, 9> pattern;
+    findSmallest(masks, leaves, pattern);
+
+    // the clue patterns of all leaves are the same, so are the cells that
+    // hold clues, and only their digits decide: clues claim labels in
+    // order, the first larger one rules a choice out
+    std::array<uint8_t, 81> clueRows, clueColumns;
+    int clueCount = 0;
+    for (int row = 0; row < 9; ++row) {
+        for (int column = 0; column < 9; ++column) {
+            // no branching on clues, whether a cell is one is anyone's guess
+            clueRows[clueCount] = static_cast<uint8_t>(row);
+            clueColumns[clueCount] = static_cast<uint8_t>(column);
+            clueCount += pattern[row] >> (8 - column) & 1;
+        }
+    }
+
+    // a target cell's source is rowSources[row] + columnSources[column]
+    std::array<uint8_t, 9> bestRows = {}, bestColumns = {};
+    std::array<char, 10> bestLabels = {};
+    char bestNext = 1;
+    std::array<char, 81> bestClues;
+    bestClues.fill(10);
+    for (const auto& leaf : leaves) {
+        std::array<uint8_t, 9> rowSources;
+        for (int row = 0; row < 9; ++row) {
+            rowSources[row] = static_cast<uint8_t>(leaf.transposed ? leaf.rows[row] : leaf.rows[row] * 9);
+        }
+        forColumnOrders(leaf.columns, [&](const std::array<uint8_t, 9>& columns) {
+            std::array<uint8_t, 9> columnSources;
+            for (int column = 0; column < 9; ++column) {
+                columnSources[column] = static_cast<uint8_t>(leaf.transposed ? columns[column] * 9 : columns[column]);
+            }
+
+            std::array<char, 10> labels = {};
+            char next = 1;
+            bool smaller = false;
+            std::array<char, 81> clues;
+            for (int clue = 0; clue < clueCount; ++clue) {
+                const int digit = sudoku.Number[rowSources[clueRows[clue]] + columnSources[clueColumns[clue]]];
+                const bool fresh = digit != 0 && labels[digit] == 0;
+                labels[digit] = fresh ? next : labels[digit];
+                next += fresh;
+                const char label = labels[digit];
+                if (!smaller) {
+                    if (label > bestClues[clue]) {
+                        return;
+                    }
+                    smaller = label < bestClues[clue];
+                }
+                clues[clue] = label;
+            }
+            if (smaller) {
+                bestClues = clues;
+                bestRows = rowSources;
+                bestColumns = columnSources;
+                bestLabels = labels;
+                bestNext = next;
+            }
+        });
+    }
+
+    // the solution fills in the labels the clues left
+    Sudoku best = {};
+    for (int row = 0; row < 9; ++row) {
+        for (int column = 0; column < 9; ++column) {
+            const int from = bestRows[row] + bestColumns[column];
+            const int digit = sudoku.Number[from];
+            if (digit != 0 && bestLabels[digit] == 0) {
+                bestLabels[digit] = bestNext++;
+            }
+            best.Number[row * 9 + column] = bestLabels[digit];
+            best.HintMask[row * 9 + column] = sudoku.HintMask[from];
+        }
+    }
+    return best;
+}
+
+uint64_t Canonical::hash(const Sudoku& canonical) {
+    // clues packed 16 to a word, each word mixed in as a whole
+    uint64_t hash = 0x9e3779b97f4a7c15ull;
+    for (int word = 0; word < 6; ++word) {
+        uint64_t packed = 0;
+        for (int cell = word * 16; cell < std::min(word * 16 + 16, 81); ++cell) {
+            const uint64_t clue = static_cast<uint64_t>(canonical.Number[cell]) * canonical.HintMask[cell];
+            packed = packed << 4 | clue;
+        }
+        hash = (hash ^ packed) * 0xbf58476d1ce4e5b9ull;
+        hash ^= hash >> 31;
+    }
+    return hash ^ hash >> 29;
+}
+
+// 0 marks a free slot, a hash that happens to be 0 is stored as 1
+static uint64_t slotHash(uint64_t hash) {
+    return hash == 0 ? 1 : hash;
+}
+
+CanonicalIndex::CanonicalIndex(size_t expected) {
+    const size_t capacity = std::bit_ceil(std::max<size_t>(expected * 2, 16));
+    hashes.assign(capacity, 0);
+    ids.assign(capacity, 0);
+}
+
+std::optional<uint32_t> CanonicalIndex::insert(uint64_t hash, uint32_t id) {
+    if ((count + 1) * 2 > hashes.size()) {
+        grow();
+    }
+
+    hash = slotHash(hash);
+    const size_t mask = hashes.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        if (hashes[slot] == hash) {
+            return ids[slot];
+        }
+        if (hashes[slot] == 0) {
+            hashes[slot] = hash;
+            ids[slot] = id;
+            ++count;
+            return std::nullopt;
+        }
+    }
+}
+
+void CanonicalIndex::grow() {
+    std::vector<uint64_t> oldHashes(hashes.size() * 2, 0);
+    std::vector<uint32_t> oldIds(ids.size() * 2, 0);
+    oldHashes.swap(hashes);
+    oldIds.swap(ids);
+
+    const size_t mask = hashes.size() - 1;
+    for (size_t i = 0; i < oldHashes.size(); ++i) {
+        if (oldHashes[i] == 0) {
+            continue;
+        }
+        size_t slot = oldHashes[i] & mask;
+        while (hashes[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        hashes[slot] = oldHashes[i];
+        ids[slot] = oldIds[i];
+    }
+}
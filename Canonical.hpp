@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "Sudoku.hpp"
+
+// One representative per class of equivalent puzzles, i.e. of everything
+// Sudoku::transformed can turn a puzzle into. The clue pattern is made
+// lexicographically smallest first, which only takes following the few
+// row choices that keep it smallest side by side, a row at a time, then
+// digits are relabelled in order of first appearance and the smallest
+// relabelling among the remaining choices wins.
+class Canonical {
+public:
+    // The same Sudoku for every puzzle of the class, solution included.
+    static Sudoku form(const Sudoku& sudoku);
+    // Of a canonical form, its clues are all that set it apart.
+    static uint64_t hash(const Sudoku& canonical);
+};
+
+// Canonical hashes and the id of the first puzzle seen with each. Open
+// addressing over 12 bytes per entry, so tens of millions fit comfortably.
+class CanonicalIndex {
+public:
+    explicit CanonicalIndex(size_t expected = 1024);
+
+    // The id already stored for `hash`, otherwise stores `id`. Whether the
+    // two are really the same puzzle or just share a hash is for the caller
+    // to tell by comparing their canonical forms.
+    std::optional<uint32_t> insert(uint64_t hash, uint32_t id);
+    size_t size() const { return count; }
+
+private:
+    void grow();
+
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> ids;
+    size_t count = 0;
+};
@@ -0,0 +1,95 @@
+#include "Generator.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include "Rater.hpp"
+#include "Solver.hpp"
+
+int Generator::targetClues(Sudoku::Difficulty level) {
+    // where a grid dug that far most cheaply rates as the level, the rater
+    // decides the level itself
+    switch (level) {
+    case Sudoku::Difficulty::Easy:
+        return 38;
+    case Sudoku::Difficulty::Medium:
+        return 32;
+    case Sudoku::Difficulty::Hard:
+        return 28;
+    case Sudoku::Difficulty::Expert:
+        return 28;
+    }
+    return 81;
+}
+
+static std::optional<Sudoku> dig(
+    Sudoku::Difficulty level,
+    uint32_t seed,
+    std::chrono::steady_clock::time_point deadline,
+    int grids) {
+    const int target = Generator::targetClues(level);
+
+    std::mt19937 random(seed);
+    std::array<uint8_t, 81> order;
+    std::iota(order.begin(), order.end(), 0);
+
+    for (int grid = 0; grid < grids && std::chrono::steady_clock::now() < deadline; ++grid) {
+        auto solution = Solver::solveRandom(Solver::Board{}, random() | 1);
+        if (!solution.has_value()) {
+            return std::nullopt;
+        }
+
+        Solver::Board cells = solution.value();
+        int clues = 81;
+
+        std::shuffle(order.begin(), order.end(), random);
+        for (auto cell : order) {
+            if (clues <= target) {
+                break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return std::nullopt;
+            }
+
+            cells[cell] = 0;
+            if (Solver::hasUniqueSolution(cells)) {
+                --clues;
+            } else {
+                cells[cell] = solution.value()[cell];
+            }
+        }
+
+        if (clues > target) {
+            // minimal puzzle with too many clues, start over with a new grid
+            continue;
+        }
+        if (Rater::difficulty(Rater::rate(cells)) != level) {
+            // the clue count is only a hint, how it solves decides
+            continue;
+        }
+
+        Sudoku sudoku = {};
+        for (size_t i = 0; i < 81; ++i) {
+            sudoku.Number[i] = solution.value()[i];
+            sudoku.HintMask[i] = cells[i] != 0;
+        }
+        return sudoku;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<Sudoku> Generator::generate(
+    Sudoku::Difficulty level,
+    uint32_t seed,
+    std::chrono::microseconds budget) {
+    return dig(level, seed, std::chrono::steady_clock::now() + budget, std::numeric_limits<int>::max());
+}
+
+std::optional<Sudoku> Generator::generate(
+    Sudoku::Difficulty level,
+    uint32_t seed,
+    int grids) {
+    return dig(level, seed, std::chrono::steady_clock::time_point::max(), grids);
+}
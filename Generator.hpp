@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "Sudoku.hpp"
+
+// Builds fresh unique-solution puzzles on the device.
+class Generator {
+public:
+    // Fills a random grid, then removes clues in random order as long as
+    // the solution stays unique until the difficulty's clue count is hit.
+    // Starts over unless Rater puts the result in `level`. Gives up with
+    // std::nullopt once `budget` has elapsed.
+    static std::optional<Sudoku> generate(
+        Sudoku::Difficulty level,
+        uint32_t seed,
+        std::chrono::microseconds budget);
+
+    // Same, but gives up after digging `grids` filled grids instead of at
+    // a deadline, so the result depends on the seed alone.
+    static std::optional<Sudoku> generate(
+        Sudoku::Difficulty level,
+        uint32_t seed,
+        int grids);
+
+    static int targetClues(Sudoku::Difficulty level);
+};
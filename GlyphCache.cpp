@@ -0,0 +1,105 @@
+#include "GlyphCache.hpp"
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include "res/digits.hpp"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// NumberScale is practically the only scale in use, a handful is plenty
+constexpr const size_t MaxScales = 4;
+
+struct GlyphSet {
+    float scale;
+    std::array<QList<LinePoint>, 9> glyphs;
+};
+
+// Sets are immutable once built, so a thread can keep using the last one
+// it looked up without taking the lock even after it has been evicted.
+static std::mutex glyphSetsLock;
+static std::array<std::shared_ptr<const GlyphSet>, MaxScales> glyphSets;
+static size_t nextEviction = 0;
+static thread_local std::shared_ptr<const GlyphSet> lastGlyphSet;
+
+static std::shared_ptr<const GlyphSet> buildGlyphSet(float scale) {
+    auto set = std::make_shared<GlyphSet>();
+    set->scale = scale;
+    for (size_t digit = 0; digit < 9; ++digit) {
+        auto points = DigitPoints[digit];
+        QList<LinePoint> glyph(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            glyph[i] = (LinePoint){
+                points[i].x *  scale,
+                points[i].y * -scale,
+                25, 25, 0, 255};
+        }
+        set->glyphs[digit] = std::move(glyph);
+    }
+    return set;
+}
+
+static const GlyphSet& findGlyphSet(float scale) {
+    if (lastGlyphSet && lastGlyphSet->scale == scale) {
+        return *lastGlyphSet;
+    }
+
+    std::lock_guard lock(glyphSetsLock);
+
+    for (const auto& set : glyphSets) {
+        if (set && set->scale == scale) {
+            lastGlyphSet = set;
+            return *lastGlyphSet;
+        }
+    }
+
+    auto& slot = glyphSets[nextEviction++ % MaxScales];
+    slot = buildGlyphSet(scale);
+    lastGlyphSet = slot;
+    return *lastGlyphSet;
+}
+
+QList<LinePoint> GlyphCache::place(int number, const QPointF& center, float scale) {
+    if (number < 1 || number > 9) {
+        return {};
+    }
+
+    const QList<LinePoint>& templatePoints = findGlyphSet(scale).glyphs[number - 1];
+
+    QList<LinePoint> points(templatePoints.begin(), templatePoints.end());
+    translate(points.data(), points.size(),
+        static_cast<float>(center.x()), static_cast<float>(center.y()));
+    return points;
+}
+
+void GlyphCache::translate(LinePoint* points, size_t count, float dx, float dy) {
+    // x and y are adjacent floats at the start of every packed 14 byte
+    // point, so each point is one unaligned 64 bit load, add and store.
+    auto* bytes = reinterpret_cast<unsigned char*>(points);
+#if defined(__ARM_NEON)
+    const float32x2_t offset = { dx, dy };
+    for (size_t i = 0; i < count; ++i, bytes += sizeof(LinePoint)) {
+        float32x2_t xy = vreinterpret_f32_u8(vld1_u8(bytes));
+        vst1_u8(bytes, vreinterpret_u8_f32(vadd_f32(xy, offset)));
+    }
+#elif defined(__SSE2__)
+    const __m128 offset = _mm_setr_ps(dx, dy, 0.0f, 0.0f);
+    for (size_t i = 0; i < count; ++i, bytes += sizeof(LinePoint)) {
+        __m128 xy = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(bytes), _mm_castps_si128(_mm_add_ps(xy, offset)));
+    }
+#else
+    for (size_t i = 0; i < count; ++i, bytes += sizeof(LinePoint)) {
+        float xy[2];
+        std::memcpy(xy, bytes, sizeof(xy));
+        xy[0] += dx;
+        xy[1] += dy;
+        std::memcpy(bytes, xy, sizeof(xy));
+    }
+#endif
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+#include "rm_Line.hpp"
+
+// Digit glyphs pre-scaled around the origin, so placing one is a copy
+// plus a translation instead of scaling every DigitPoints coordinate.
+class GlyphCache {
+public:
+    // Points of digit `number` (1-9) centered on `center`.
+    static QList<LinePoint> place(int number, const QPointF& center, float scale);
+
+    static void translate(LinePoint* points, size_t count, float dx, float dy);
+};
@@ -0,0 +1,179 @@
+#include "PlayedSet.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+constexpr const char MAGIC[8] = { 'P', 'L', 'A', 'Y', 'E', 'D', '0', '0' };
+constexpr const size_t PLAYED_HEADER_SIZE = 0x10;
+constexpr const uint64_t AllPlayed = ~0ull;
+
+template <typename T>
+static T get(const uchar* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template <typename T>
+static void put(uchar* data, T value) {
+    std::memcpy(data, &value, sizeof(T));
+}
+
+// Bits [from, 64) of a word.
+static uint64_t bitsFrom(size_t from) {
+    return from >= 64 ? 0 : AllPlayed << from;
+}
+
+// The bits of the last word past its first `used` entries.
+static uint64_t pastEnd(size_t used) {
+    return bitsFrom(used % 64 == 0 ? 64 : used % 64);
+}
+
+// The first clear bit at or after `from`, or SIZE_MAX.
+static size_t firstClear(const std::vector<uint64_t>& bits, size_t from) {
+    for (size_t word = from / 64; word < bits.size(); ++word) {
+        const uint64_t clear = ~bits[word] & (word == from / 64 ? bitsFrom(from % 64) : AllPlayed);
+        if (clear != 0) {
+            return word * 64 + std::countr_zero(clear);
+        }
+    }
+    return SIZE_MAX;
+}
+
+bool PlayedSet::open(const char* path, uint32_t recordCount, uint32_t checksum) {
+    close();
+    if (recordCount == 0) {
+        return false;
+    }
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        printf("Failed to open played set: %s\n", path);
+        return false;
+    }
+
+    const size_t wordTotal = (static_cast<size_t>(recordCount) + 63) / 64;
+    const qint64 size = static_cast<qint64>(PLAYED_HEADER_SIZE + wordTotal * sizeof(uint64_t));
+    bool fresh = file.size() != size;
+    if (fresh && !file.resize(size)) {
+        printf("Failed to size played set: %s\n", path);
+        file.close();
+        return false;
+    }
+
+    data = file.map(0, size);
+    if (data == nullptr) {
+        printf("Failed to map played set: %s\n", path);
+        file.close();
+        return false;
+    }
+
+    fresh = fresh
+        || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0
+        || get<uint32_t>(data + 0x08) != recordCount
+        || get<uint32_t>(data + 0x0c) != checksum;
+    if (fresh) {
+        std::memcpy(data, MAGIC, sizeof(MAGIC));
+        put<uint32_t>(data + 0x08, recordCount);
+        put<uint32_t>(data + 0x0c, checksum);
+    }
+
+    // the mapping is page aligned, so the words after the header are too
+    words = reinterpret_cast<uint64_t*>(data + PLAYED_HEADER_SIZE);
+    wordCount = wordTotal;
+    count = recordCount;
+    fullWords.resize((wordCount + 63) / 64);
+    fullGroups.resize((fullWords.size() + 63) / 64);
+    if (fresh) {
+        reset();
+        return true;
+    }
+
+    clearFull();
+    words[wordCount - 1] |= pastEnd(count);
+    playedCount = 0;
+    for (size_t word = 0; word < wordCount; ++word) {
+        playedCount += std::popcount(words[word]);
+        if (words[word] == AllPlayed) {
+            markFull(word);
+        }
+    }
+    playedCount -= static_cast<uint32_t>(wordCount * 64 - count);
+    return true;
+}
+
+void PlayedSet::close() {
+    if (data != nullptr) {
+        file.unmap(data);
+    }
+    file.close();
+    data = nullptr;
+    words = nullptr;
+    wordCount = 0;
+    count = 0;
+    playedCount = 0;
+    fullWords.clear();
+    fullGroups.clear();
+}
+
+void PlayedSet::reset() {
+    std::fill(words, words + wordCount, 0);
+    words[wordCount - 1] = pastEnd(count);
+    playedCount = 0;
+    clearFull();
+}
+
+void PlayedSet::clearFull() {
+    // past the end counts as played, so it's never picked
+    std::fill(fullWords.begin(), fullWords.end(), 0);
+    std::fill(fullGroups.begin(), fullGroups.end(), 0);
+    fullWords.back() = pastEnd(wordCount);
+    fullGroups.back() = pastEnd(fullWords.size());
+}
+
+void PlayedSet::markFull(size_t word) {
+    uint64_t& group = fullWords[word / 64];
+    group |= 1ull << (word % 64);
+    if (group == AllPlayed) {
+        fullGroups[word / 4096] |= 1ull << (word / 64 % 64);
+    }
+}
+
+size_t PlayedSet::nextOpenWord(size_t word) const {
+    // within its own group first
+    const uint64_t open = ~fullWords[word / 64] & bitsFrom(word % 64);
+    if (open != 0) {
+        return word / 64 * 64 + std::countr_zero(open);
+    }
+
+    // then the next group with an open word, wrapping around
+    size_t group = firstClear(fullGroups, word / 64 + 1);
+    if (group == SIZE_MAX) {
+        group = firstClear(fullGroups, 0);
+    }
+    return group * 64 + std::countr_zero(~fullWords[group]);
+}
+
+uint32_t PlayedSet::take(uint64_t random) {
+    if (playedCount == count) {
+        printf("Played every one of %u puzzles, starting over\n", count);
+        reset();
+    }
+
+    const size_t word = nextOpenWord(static_cast<uint32_t>(random) % count / 64);
+    // any of the word's open records, not just the first
+    uint64_t open = ~words[word];
+    for (int skip = static_cast<int>((random >> 32) % std::popcount(open)); skip > 0; --skip) {
+        open &= open - 1;
+    }
+    const int bit = std::countr_zero(open);
+
+    words[word] |= 1ull << bit;
+    ++playedCount;
+    if (words[word] == AllPlayed) {
+        markFull(word);
+    }
+    return static_cast<uint32_t>(word * 64 + bit);
+}
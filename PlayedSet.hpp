@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <QFile>
+
+// One bit per record of a pack, set once the record has been played, so
+// random picks don't repeat until the whole pack has been through. The
+// bits are a memory mapped file and outlive the plugin.
+//
+// Layout, little endian:
+//   0x00  char[8]  "PLAYED00"
+//   0x08  u32      record count
+//   0x0c  u32      checksum of the pack, a file for another pack starts over
+//   0x10  u64[(count + 63) / 64]  record i is bit i % 64 of word i / 64,
+//                  the bits past the last record are always set
+class PlayedSet {
+public:
+    PlayedSet() = default;
+    ~PlayedSet() { close(); }
+
+    PlayedSet(const PlayedSet&) = delete;
+    PlayedSet& operator=(const PlayedSet&) = delete;
+
+    bool open(const char* path, uint32_t count, uint32_t checksum);
+    void close();
+    bool isOpen() const { return words != nullptr; }
+    uint32_t size() const { return count; }
+    uint32_t played() const { return playedCount; }
+
+    // An unplayed record picked by `random`, which is marked played. Once
+    // every record has been played they all start over.
+    uint32_t take(uint64_t random);
+
+private:
+    void reset();
+    // Only what lies past the end marked full.
+    void clearFull();
+    void markFull(size_t word);
+    // The first word at or after `word` with an unplayed record, wrapping
+    // around. There has to be one.
+    size_t nextOpenWord(size_t word) const;
+
+    QFile file;
+    uchar* data = nullptr;
+    uint64_t* words = nullptr;
+    size_t wordCount = 0;
+    uint32_t count = 0;
+    uint32_t playedCount = 0;
+    // a bit per word with every record played, and a bit per word of those
+    // that is all ones, so finding an open word skips 4096 records a step
+    std::vector<uint64_t> fullWords;
+    std::vector<uint64_t> fullGroups;
+};
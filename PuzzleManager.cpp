@@ -1,8 +1,17 @@
 #include "PuzzleManager.hpp"
 
+#include <QDir>
+#include <QMetaMethod>
 #include <QRandomGenerator>
+#include <QStandardPaths>
+#include <cmath>
+#include <utility>
+#include "Generator.hpp"
+#include "GlyphCache.hpp"
+#include "Recognizer.hpp"
+#include "SceneItemPool.hpp"
 #include "Sudoku.hpp"
-#include "res/digits.hpp"
+#include "Tessellation.hpp"
 #include "rm_SceneLineItem.hpp"
 
 constexpr const float ScreenHeight = 1872.0f;
@@ -13,6 +22,15 @@ constexpr const float CellRadius = CellSize / 2.0f;
 constexpr const float GridStartX = -(CellSize * 4.5f);
 constexpr const float GridStartY = (ScreenHeight / 2.0f) - (CellSize * 4.5f);
 constexpr const float NumberScale = 40.0f;
+constexpr const char* PlacementNames[] = {
+    "correct", "wrong", "conflict", "solved", "rejected",
+};
+
+constexpr const char* DefaultStrokeRecording = "/home/root/sudoku-strokes.bin";
+// strokes further apart than this start a new digit
+constexpr const auto StrokeGroupTimeout = std::chrono::milliseconds(1000);
+// generation is abandoned for the bundled packs after this long
+constexpr const auto GeneratorBudget = std::chrono::milliseconds(100);
 
 constexpr auto generateSudokuGrid()
 {
@@ -54,23 +72,81 @@ constexpr auto generateSudokuGrid()
     return pts;
 }
 
-constexpr auto generateCircle(float radius, Coordinate center, LinePoint* destination, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        LinePoint& pt = destination[i];
-        float angle = (static_cast<float>(i) / static_cast<float>(count - 1)) * 2.0f * 3.14159265f;
-        pt.x = center.x + radius * cos(angle);
-        pt.y = center.y + radius * sin(angle);
-        pt.speed = 25;
-        pt.width = 25;
-        pt.direction = 0;
-        pt.pressure = 255;
+constexpr auto sudokuPoints = generateSudokuGrid();
+
+PuzzleManager::PuzzleManager(QObject *parent)
+    : QObject(parent),
+      queue([this](Sudoku::Difficulty level) -> std::optional<PuzzleQueue::Puzzle> {
+          auto sudoku = loadSudoku(static_cast<int>(level));
+          if (!sudoku.has_value()) {
+              return std::nullopt;
+          }
+          return preparePuzzle(sudoku.value());
+      }),
+      strokes([this](const StrokePipeline::Stroke& stroke) {
+          analyzeStroke(stroke);
+      }) {
+    // bundled puzzles don't repeat until all of them have been played,
+    // prefetched ones included
+    const QString played = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/xovi-sudoku";
+    if (QDir().mkpath(played)) {
+        Sudoku::rememberPlayed(played.toLocal8Bit().constData());
     }
+    queue.start();
 }
 
-constexpr auto sudokuPoints = generateSudokuGrid();
-
 void PuzzleManager::logLine(const Line &line) {
-    Line::log(line);
+    recorder.record(line);
+    strokes.push(line);
+}
+
+void PuzzleManager::analyzeStroke(const StrokePipeline::Stroke& stroke) {
+    Tracer::Span span(Tracer::Phase::Recognize);
+
+    if (stroke.points.empty()) {
+        return;
+    }
+    float minX = stroke.points[0].x, maxX = minX;
+    float minY = stroke.points[0].y, maxY = minY;
+    for (const auto& point : stroke.points) {
+        minX = std::min(minX, point.x);
+        maxX = std::max(maxX, point.x);
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+
+    // strokes spilling far out of a cell aren't part of a digit
+    const int column = static_cast<int>(std::floor(((minX + maxX) / 2.0f - GridStartX) / CellSize));
+    const int row = static_cast<int>(std::floor(((minY + maxY) / 2.0f - GridStartY) / CellSize));
+    if (column < 0 || column >= 9 || row < 0 || row >= 9
+        || maxX - minX > CellSize * 1.5f || maxY - minY > CellSize * 1.5f) {
+        pendingStrokes.clear();
+        pendingCell = -1;
+        return;
+    }
+
+    const int cell = row * 9 + column;
+    if (cell != pendingCell || std::chrono::nanoseconds(stroke.enqueued - lastStroke) > StrokeGroupTimeout) {
+        pendingStrokes.clear();
+    }
+    pendingCell = cell;
+    lastStroke = stroke.enqueued;
+    pendingStrokes.append(QList<LinePoint>(stroke.points.begin(), stroke.points.end()));
+
+    auto match = Recognizer::recognize(pendingStrokes);
+    if (!match.has_value()) {
+        return;
+    }
+
+    const size_t strokeCount = static_cast<size_t>(pendingStrokes.size());
+    const uint64_t enqueued = stroke.enqueued;
+    QMetaObject::invokeMethod(this, [this, column, row, strokeCount, enqueued, match = match.value()] {
+        const auto placement = placeDigit(column, row, match.digit);
+        strokes.recordResult(enqueued);
+        printf("Recognized %d in column %d, row %d from %zu strokes (distance %.3f): %s\n",
+            match.digit, column, row, strokeCount, match.distance, PlacementNames[placement]);
+        emit digitRecognized(column, row, match.digit);
+    }, Qt::QueuedConnection);
 }
 
 Line PuzzleManager::createGrid() {
@@ -79,13 +155,15 @@ Line PuzzleManager::createGrid() {
         QPointF(0.0f, ScreenCenter), GridSize / 2.0f + 15.0f);
 }
 
-Line PuzzleManager::createCircle(const QPointF& _center, float radius) {
-    QList<LinePoint> circlePoints(100);
-
-    auto center = Coordinate{static_cast<float>(_center.x()), static_cast<float>(_center.y())};
-    generateCircle(radius, center, circlePoints.data(), circlePoints.size());
+QPointF PuzzleManager::cellCenter(int column, int row) const {
+    return {
+        GridStartX + (column + 0.5f) * CellSize,
+        GridStartY + (row + 0.5f) * CellSize
+    };
+}
 
-    return Line::fromPoints(std::move(circlePoints), _center, radius * 1.1);
+Line PuzzleManager::createCircle(const QPointF& center, float radius) {
+    return Line::fromPoints(Tessellation::circle(center, radius), center, radius * 1.1);
 }
 
 Line PuzzleManager::createLine(const QPointF& start, const QPointF& end) {
@@ -103,9 +181,45 @@ Line PuzzleManager::createLine(const QPointF& start, const QPointF& end) {
     return Line::fromPoints(std::move(linePoints), bounds);
 }
 
-QVariant PuzzleManager::getSudoku(int level) {
+std::optional<Sudoku> PuzzleManager::loadSudoku(int level) {
     auto difficulty = static_cast<Sudoku::Difficulty>(level);
-    auto sudokuOpt = Sudoku::loadFromResource(difficulty, std::nullopt);
+    if (level < 0 || level > static_cast<int>(Sudoku::Difficulty::Expert)) {
+        return Sudoku::loadFromResource(difficulty, std::nullopt);
+    }
+
+    std::optional<Sudoku> generated;
+    {
+        Tracer::Span span(Tracer::Phase::Generate);
+        generated = Generator::generate(
+            difficulty, QRandomGenerator::global()->generate(), GeneratorBudget);
+    }
+    if (generated.has_value()) {
+        return generated;
+    }
+
+    printf("Sudoku generation exceeded %lldms\n", static_cast<long long>(GeneratorBudget.count()));
+    return loadBundledSudoku(level);
+}
+
+std::optional<Sudoku> PuzzleManager::loadBundledSudoku(int level) {
+    auto difficulty = static_cast<Sudoku::Difficulty>(level);
+    if (level < 0 || level > static_cast<int>(Sudoku::Difficulty::Expert)) {
+        return Sudoku::loadFromResource(difficulty, std::nullopt);
+    }
+
+    // a fresh variant each time, so the pack doesn't start repeating. The
+    // index and variant together load the same puzzle again.
+    const auto index = Sudoku::pickFromResource(difficulty);
+    if (!index.has_value()) {
+        return std::nullopt;
+    }
+    const uint32_t variant = QRandomGenerator::global()->generate();
+    printf("Using bundled puzzle %d variant %08x\n", index.value(), variant);
+    return Sudoku::loadFromResource(difficulty, index, variant);
+}
+
+QVariant PuzzleManager::getSudoku(int level) {
+    auto sudokuOpt = loadSudoku(level);
     if (!sudokuOpt.has_value()) {
         return QVariant();
     }
@@ -130,29 +244,237 @@ QVariant PuzzleManager::getSudokuNumber(
         return QVariant();
     }
 
-    QPointF center = {
-        GridStartX + (column + 0.5f) * CellSize,
-        GridStartY + (row + 0.5f) * CellSize
-    };
-
-    return getNumber(number, center, NumberScale);
+    return getNumber(number, cellCenter(column, row), NumberScale);
 }
 
 QVariant PuzzleManager::getNumber(int number, const QPointF& center, float scale) {
-    auto points = DigitPoints[number - 1];
-    auto pointCount = points.size();
+    return QVariant::fromValue(createNumber(number, center, scale));
+}
 
-    QList<LinePoint> linePoints(pointCount);
+Line PuzzleManager::createNumber(int number, const QPointF& center, float scale) {
+    return Line::fromPoints(GlyphCache::place(number, center, scale), center, scale);
+}
 
-    for (size_t i = 0; i < pointCount; i++) {
-        linePoints[i] = (LinePoint){
-            static_cast<float>(center.x()) + points[i].x *  scale,
-            static_cast<float>(center.y()) + points[i].y * -scale,
-            25, 25, 0, 255};
+QList<Line> PuzzleManager::buildSudokuLines(const Sudoku& sudoku, bool maskHint) {
+    Tracer::Span span(Tracer::Phase::Glyphs);
+
+    QList<Line> lines;
+    lines.reserve(81 + 1);
+
+    for (int idx = 0; idx < 81; ++idx) {
+        int number = sudoku.Number[idx];
+        if (number < 1 || number > 9) {
+            continue;
+        }
+
+        if (maskHint && !sudoku.HintMask[idx]) {
+            continue;
+        }
+
+        QPointF center = {
+            GridStartX + (idx % 9 + 0.5f) * CellSize,
+            GridStartY + (idx / 9 + 0.5f) * CellSize
+        };
+        lines.append(createNumber(number, center, NumberScale));
     }
 
-    auto line = Line::fromPoints(std::move(linePoints), center, scale);
-    return QVariant::fromValue(std::move(line));
+    lines.append(createGrid());
+
+    return lines;
+}
+
+QVariantList PuzzleManager::getSudokuLines(int level) {
+    Tracer::Span span(Tracer::Phase::Lines);
+
+    auto puzzle = takePuzzle(level);
+    if (!puzzle.has_value()) {
+        return QVariantList();
+    }
+    board.reset(puzzle->sudoku);
+    lastLines = puzzle->lines;
+    lastBounds = puzzle->bounds;
+
+    QVariantList result;
+    result.reserve(lastLines.size());
+    for (const auto& line : std::as_const(lastLines)) {
+        result.append(QVariant::fromValue(line));
+    }
+    return result;
+}
+
+QList<std::shared_ptr<SceneItem>> PuzzleManager::copySudoku(int level) {
+    Tracer::Span span(Tracer::Phase::Lines);
+
+    auto puzzle = takePuzzle(level);
+    if (!puzzle.has_value()) {
+        return {};
+    }
+
+    // the grid is centered on (0, ScreenCenter)
+    SceneItemPool pool(puzzle->lines.size());
+    QList<std::shared_ptr<SceneItem>> items;
+    items.reserve(puzzle->lines.size());
+    for (auto& line : puzzle->lines) {
+        GlyphCache::translate(line.points.data(), line.points.size(), 0.0f, -ScreenCenter);
+        line.bounds.translate(0.0, -ScreenCenter);
+        items.append(pool.make(std::move(line)));
+    }
+    return items;
+}
+
+std::optional<PuzzleQueue::Puzzle> PuzzleManager::takePuzzle(int level) {
+    auto puzzle = queue.take(static_cast<Sudoku::Difficulty>(level));
+    if (puzzle.has_value()) {
+        return puzzle;
+    }
+
+    // generating here would stall the UI, the worker refills the queue
+    auto sudoku = loadBundledSudoku(level);
+    if (!sudoku.has_value()) {
+        return std::nullopt;
+    }
+    return preparePuzzle(sudoku.value());
+}
+
+PuzzleQueue::Puzzle PuzzleManager::preparePuzzle(const Sudoku& sudoku) {
+    PuzzleQueue::Puzzle puzzle{sudoku, buildSudokuLines(sudoku), QRectF()};
+    for (const auto& line : std::as_const(puzzle.lines)) {
+        puzzle.bounds |= line.bounds;
+    }
+    return puzzle;
+}
+
+bool PuzzleManager::renderSudokuToTiles(QObject* tileManager) {
+    if (tileManager == nullptr) {
+        return false;
+    }
+
+    const QMetaObject* meta = tileManager->metaObject();
+    const int renderIndex = meta->indexOfMethod("renderLineToTiles(Line)");
+    if (renderIndex < 0) {
+        return false;
+    }
+
+    const QMetaMethod render = meta->method(renderIndex);
+    {
+        Tracer::Span span(Tracer::Phase::RenderLineToTiles);
+        for (const auto& line : std::as_const(lastLines)) {
+            render.invoke(tileManager, Qt::DirectConnection, Q_ARG(Line, line));
+        }
+    }
+
+    Tracer::Span span(Tracer::Phase::Reload);
+    const int reloadIndex = meta->indexOfMethod("reload(QRectF)");
+    if (reloadIndex >= 0) {
+        meta->method(reloadIndex).invoke(tileManager, Qt::DirectConnection, Q_ARG(QRectF, lastBounds));
+    } else {
+        QMetaObject::invokeMethod(tileManager, "reload", Qt::DirectConnection);
+    }
+    return true;
+}
+
+PuzzleManager::Placement PuzzleManager::placeDigit(int column, int row, int digit) {
+    if (row < 0 || row >= 9 || column < 0 || column >= 9 || digit < 1 || digit > 9) {
+        return PlacementRejected;
+    }
+    return static_cast<Placement>(board.place(row * 9 + column, digit));
+}
+
+bool PuzzleManager::clearDigit(int column, int row) {
+    if (row < 0 || row >= 9 || column < 0 || column >= 9) {
+        return false;
+    }
+    return board.clear(row * 9 + column);
+}
+
+bool PuzzleManager::hasConflict(int column, int row) const {
+    if (row < 0 || row >= 9 || column < 0 || column >= 9) {
+        return false;
+    }
+    return board.hasConflict(row * 9 + column);
+}
+
+void PuzzleManager::logPrefetchStats() {
+    printf("Prefetched puzzles: %llu hits, %llu misses\n",
+        static_cast<unsigned long long>(queue.hits()),
+        static_cast<unsigned long long>(queue.misses()));
+}
+
+void PuzzleManager::logStrokeStats() {
+    printf("Strokes: %llu queued, %llu dropped, %zu waiting (max %zu), "
+        "%llu recognized in %.2fms mean, %.2fms max\n",
+        static_cast<unsigned long long>(strokes.pushed()),
+        static_cast<unsigned long long>(strokes.dropped()),
+        strokes.depth(), strokes.maxDepth(),
+        static_cast<unsigned long long>(strokes.results()),
+        strokes.meanLatency() / 1e6, strokes.maxLatency() / 1e6);
+}
+
+bool PuzzleManager::startRecording(const QString& path) {
+    const QByteArray file = path.isEmpty() ? QByteArray(DefaultStrokeRecording) : path.toLocal8Bit();
+    const bool wasRecording = recorder.isOpen();
+    if (!recorder.open(file.constData())) {
+        if (wasRecording) {
+            emit recordingChanged();
+        }
+        return false;
+    }
+
+    printf("Recording strokes to %s\n", file.constData());
+    if (!wasRecording) {
+        emit recordingChanged();
+    }
+    return true;
+}
+
+void PuzzleManager::stopRecording() {
+    if (!recorder.isOpen()) {
+        return;
+    }
+    printf("Recorded %zu strokes\n", recorder.recorded());
+    recorder.close();
+    emit recordingChanged();
+}
+
+void PuzzleManager::setTracing(bool enabled) {
+    if (enabled == Tracer::enabled()) {
+        return;
+    }
+    Tracer::setEnabled(enabled);
+    emit tracingChanged();
+}
+
+double PuzzleManager::traceBegin() const {
+    return Tracer::enabled() ? static_cast<double>(Tracer::now()) : 0.0;
+}
+
+double PuzzleManager::traceEnd(TracePhase phase, double start) {
+    if (!Tracer::enabled() || start <= 0.0) {
+        return 0.0;
+    }
+
+    const uint64_t end = Tracer::now();
+    Tracer::record(static_cast<Tracer::Phase>(phase), end - static_cast<uint64_t>(start));
+    return static_cast<double>(end);
+}
+
+void PuzzleManager::dumpTrace(const QString& path) {
+    if (path.isEmpty()) {
+        Tracer::dump(stdout);
+        return;
+    }
+
+    FILE* out = fopen(path.toLocal8Bit().constData(), "w");
+    if (out == nullptr) {
+        printf("Failed to open %s for the trace\n", path.toLocal8Bit().constData());
+        return;
+    }
+    Tracer::dump(out);
+    fclose(out);
+}
+
+void PuzzleManager::resetTrace() {
+    Tracer::reset();
 }
 
 void PuzzleManager::logSceneItems(const QList<std::shared_ptr<SceneItem>>& items) {
@@ -168,20 +490,15 @@ void PuzzleManager::logSceneItems(const QList<std::shared_ptr<SceneItem>>& items
 
 QList<std::shared_ptr<SceneItem>> PuzzleManager::copyCrosshair() {
     QPointF center(0.0f, 0.0f);
+    SceneItemPool pool(6);
     QList<std::shared_ptr<SceneItem>> itemList(
         {
-            std::make_shared<SceneLineItem>(
-                SceneLineItem::fromLine(createCircle(center, 50.0f))),
-            std::make_shared<SceneLineItem>(
-                SceneLineItem::fromLine(createCircle(center, 100.0f))),
-            std::make_shared<SceneLineItem>(
-                SceneLineItem::fromLine(createCircle(center, 150.0f))),
-            std::make_shared<SceneLineItem>(
-                SceneLineItem::fromLine(createCircle(center, 200.0f))),
-            std::make_shared<SceneLineItem>(
-                SceneLineItem::fromLine(createLine(QPointF(-200.0f, 0.0f), QPointF(200.0f, 0.0f)))),
-            std::make_shared<SceneLineItem>(
-                SceneLineItem::fromLine(createLine(QPointF(0.0f, -200.0f), QPointF(0.0f, 200.0f)))),
+            pool.make(createCircle(center, 50.0f)),
+            pool.make(createCircle(center, 100.0f)),
+            pool.make(createCircle(center, 150.0f)),
+            pool.make(createCircle(center, 200.0f)),
+            pool.make(createLine(QPointF(-200.0f, 0.0f), QPointF(200.0f, 0.0f))),
+            pool.make(createLine(QPointF(0.0f, -200.0f), QPointF(0.0f, 200.0f))),
         }
     );
 
@@ -189,34 +506,20 @@ QList<std::shared_ptr<SceneItem>> PuzzleManager::copyCrosshair() {
 }
 
 Line PuzzleManager::createStar(const QPointF& center, double size, size_t points) {
-    size_t segments = points * 2;
-    QList<LinePoint> starPoints(segments + 1);
-
-    for (size_t i = 0; i < segments + 1; i++) {
-        const double angle = (static_cast<double>(i) / static_cast<double>(segments)) * 2.0 * 3.14159265;
-        const double radius = (i % 2 == 0) ? size : (size / 2.0);
-        starPoints[i] = (LinePoint){
-            static_cast<float>(center.x() + radius * cos(angle)),
-            static_cast<float>(center.y() + radius * sin(angle)),
-            25, 25, 0, 255};
-    }
-
-    return Line::fromPoints(std::move(starPoints), center, size);
+    return Line::fromPoints(Tessellation::star(center, size, points), center, size);
 }
 
 QList<std::shared_ptr<SceneItem>> PuzzleManager::copyStars(size_t count, double spread, size_t points) {
     auto random = QRandomGenerator::global();
 
+    SceneItemPool pool(count);
     QList<std::shared_ptr<SceneItem>> itemList(count);
 
     for (size_t i = 0; i < count; ++i) {
         const double size = random->bounded(60.0);
         const double x = random->bounded(spread - size) + size;
         const double y = random->bounded(spread - size) + size;
-        itemList[i] = std::make_shared<SceneLineItem>(
-            SceneLineItem::fromLine(
-                createStar(QPointF(x, y), size, points))
-        );
+        itemList[i] = pool.make(createStar(QPointF(x, y), size, points));
     }
 
     return itemList;
@@ -232,6 +535,14 @@ bool PuzzleManager::setupVtablePtr(const QList<std::shared_ptr<SceneItem>>& item
         return false;
     }
     auto* item = reinterpret_cast<SceneLineItem*>(items.first().get());
+    if (!SceneLineItem::isNormal(*item)) {
+        printf("setupVtablePtr: cloned item doesn't look like a line\n");
+        SceneLineItem::log(*item);
+        return false;
+    }
+    if (SceneLineItem::vtable_ptr != nullptr && SceneLineItem::vtable_ptr != item->vtable) {
+        printf("setupVtablePtr: cloned vtable %p differs from %p\n", item->vtable, SceneLineItem::vtable_ptr);
+    }
     SceneLineItem::setupVtable(item->vtable);
     return true;
 }
\ No newline at end of file
@@ -2,21 +2,52 @@
 
 #include <QList>
 #include <QObject>
+#include <QRectF>
 #include <QPointF>
 #include <QVariant>
+#include "BoardState.hpp"
+#include "PuzzleQueue.hpp"
+#include "StrokePipeline.hpp"
+#include "StrokeRecorder.hpp"
 #include "Sudoku.hpp"
+#include "Tracer.hpp"
 #include "rm_Line.hpp"
 #include "rm_SceneItem.hpp"
+#include "rm_SceneLineItem.hpp"
 
 class PuzzleManager : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(bool tracing READ tracing WRITE setTracing NOTIFY tracingChanged)
+    Q_PROPERTY(bool recording READ recording NOTIFY recordingChanged)
 public:
-    explicit PuzzleManager(QObject *parent = nullptr) : QObject(parent) {}
+    // Phases QML can trace, a subset of Tracer::Phase.
+    enum TracePhase {
+        TraceInsert = static_cast<int>(Tracer::Phase::Insert),
+        TraceAddDrawingLine = static_cast<int>(Tracer::Phase::AddDrawingLine),
+        TraceRenderLineToTiles = static_cast<int>(Tracer::Phase::RenderLineToTiles),
+        TraceReload = static_cast<int>(Tracer::Phase::Reload),
+    };
+    Q_ENUM(TracePhase)
 
+    enum Placement {
+        PlacementCorrect = static_cast<int>(BoardState::Placement::Correct),
+        PlacementWrong = static_cast<int>(BoardState::Placement::Wrong),
+        PlacementConflict = static_cast<int>(BoardState::Placement::Conflict),
+        PlacementSolved = static_cast<int>(BoardState::Placement::Solved),
+        PlacementRejected = static_cast<int>(BoardState::Placement::Rejected),
+    };
+    Q_ENUM(Placement)
+
+    explicit PuzzleManager(QObject *parent = nullptr);
+
+    // Completed pen strokes, queued for recognition on a worker. Strokes
+    // written into a cell in quick succession are recognized together
+    // as one digit.
     Q_INVOKABLE void logLine(const Line &line);
 
     Q_INVOKABLE Line createGrid();
+    Q_INVOKABLE QPointF cellCenter(int column, int row) const;
     Q_INVOKABLE Line createCircle(const QPointF& center, float radius);
     Q_INVOKABLE Line createLine(const QPointF& start, const QPointF& end);
 
@@ -27,6 +58,55 @@ public:
         bool maskHint);
     Q_INVOKABLE QVariant getNumber(int number, const QPointF& center, float scale);
 
+    // All hint glyphs followed by the grid, built in a single pass.
+    Q_INVOKABLE QVariantList getSudokuLines(int level);
+    QList<Line> buildSudokuLines(const Sudoku& sudoku, bool maskHint = true);
+    // Region covered by the lines last returned by getSudokuLines.
+    Q_INVOKABLE QRectF sudokuBounds() const { return lastBounds; }
+    // Renders the lines last returned by getSudokuLines in one call, then
+    // reloads only their region if `tileManager` can reload part of the
+    // view. False if it has no renderLineToTiles(Line), the lines have to
+    // be rendered one by one then.
+    Q_INVOKABLE bool renderSudokuToTiles(QObject* tileManager);
+    // Grid and hints of a new puzzle as one batch of clipboard items,
+    // centered on the origin so a single paste places the whole puzzle.
+    // Doesn't replace the puzzle written into by logLine.
+    Q_INVOKABLE QList<std::shared_ptr<SceneItem>> copySudoku(int level);
+
+    // Edits of the puzzle last returned by getSudokuLines. Givens and
+    // cells outside the grid are rejected.
+    Q_INVOKABLE Placement placeDigit(int column, int row, int digit);
+    Q_INVOKABLE bool clearDigit(int column, int row);
+    Q_INVOKABLE bool hasConflict(int column, int row) const;
+    Q_INVOKABLE int conflictCount() const { return board.conflictCount(); }
+    Q_INVOKABLE bool solved() const { return board.solved(); }
+
+    // How often getSudokuLines found a prefetched puzzle.
+    Q_INVOKABLE quint64 prefetchHits() const { return queue.hits(); }
+    Q_INVOKABLE quint64 prefetchMisses() const { return queue.misses(); }
+    Q_INVOKABLE void logPrefetchStats();
+
+    // Strokes waiting for recognition, and those dropped as the queue was full.
+    Q_INVOKABLE int strokeQueueDepth() const { return static_cast<int>(strokes.depth()); }
+    Q_INVOKABLE quint64 droppedStrokes() const { return strokes.dropped(); }
+    Q_INVOKABLE void logStrokeStats();
+
+    // Appends every completed stroke to `path`, see StrokeRecorder, or to
+    // a file in the home directory if empty.
+    bool recording() const { return recorder.isOpen(); }
+    Q_INVOKABLE bool startRecording(const QString& path = QString());
+    Q_INVOKABLE void stopRecording();
+
+    bool tracing() const { return Tracer::enabled(); }
+    void setTracing(bool enabled);
+    // Monotonic timestamps in nanoseconds. traceEnd returns the end of the
+    // span so consecutive spans can be chained.
+    Q_INVOKABLE double traceBegin() const;
+    Q_INVOKABLE double traceEnd(TracePhase phase, double start);
+    // Writes the histograms to `path`, or the log if empty.
+    Q_INVOKABLE void dumpTrace(const QString& path = QString());
+    Q_INVOKABLE void resetTrace();
+
     Q_INVOKABLE void logSceneItems(const QList<std::shared_ptr<SceneItem>>& items);
     Q_INVOKABLE QList<std::shared_ptr<SceneItem>> copyCrosshair();
 
@@ -34,5 +114,40 @@ public:
     Q_INVOKABLE QList<std::shared_ptr<SceneItem>> copyStars(size_t count, double spread, size_t points = 5);
 
     Q_INVOKABLE void sleepMs(int ms);
+    // Takes the vtable from cloned items, if they look like xochitl's.
     Q_INVOKABLE bool setupVtablePtr(const QList<std::shared_ptr<SceneItem>>& items);
+    Q_INVOKABLE bool hasVtablePtr() const { return SceneLineItem::vtable_ptr != nullptr; }
+
+signals:
+    void tracingChanged();
+    void recordingChanged();
+    // Emitted again with a better guess if the digit takes more strokes.
+    // Recognition runs on the stroke worker, this arrives queued.
+    void digitRecognized(int column, int row, int digit);
+
+private:
+    // Generates a fresh puzzle, falling back to the bundled packs.
+    static std::optional<Sudoku> loadSudoku(int level);
+    // A random variant of a bundled puzzle not played yet.
+    static std::optional<Sudoku> loadBundledSudoku(int level);
+    static Line createNumber(int number, const QPointF& center, float scale);
+    // A prefetched puzzle, or a bundled one if none is ready.
+    std::optional<PuzzleQueue::Puzzle> takePuzzle(int level);
+    PuzzleQueue::Puzzle preparePuzzle(const Sudoku& sudoku);
+    // Runs on the stroke worker.
+    void analyzeStroke(const StrokePipeline::Stroke& stroke);
+
+    PuzzleQueue queue;
+    BoardState board;
+    QList<Line> lastLines;
+    QRectF lastBounds;
+    StrokeRecorder recorder;
+
+    // strokes of the digit currently being written, owned by the worker
+    QList<QList<LinePoint>> pendingStrokes;
+    int pendingCell = -1;
+    uint64_t lastStroke = 0;
+
+    // last, so the worker is gone before the state it uses
+    StrokePipeline strokes;
 };
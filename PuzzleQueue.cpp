@@ -0,0 +1,114 @@
+#include "PuzzleQueue.hpp"
+
+#include <algorithm>
+#include "Tracer.hpp"
+
+// a difficulty that fails to build is retried after this, doubling with
+// every failure in a row
+constexpr const auto RetryDelay = std::chrono::milliseconds(250);
+constexpr const auto MaxRetryDelay = std::chrono::seconds(16);
+
+PuzzleQueue::PuzzleQueue(Builder builder)
+    : builder(std::move(builder)) {
+}
+
+PuzzleQueue::~PuzzleQueue() {
+    {
+        std::lock_guard guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PuzzleQueue::start() {
+    if (!worker.joinable()) {
+        worker = std::thread(&PuzzleQueue::run, this);
+    }
+}
+
+std::optional<PuzzleQueue::Puzzle> PuzzleQueue::take(Sudoku::Difficulty level) {
+    const size_t difficulty = static_cast<size_t>(level);
+    if (difficulty >= Difficulties) {
+        return std::nullopt;
+    }
+
+    std::optional<Puzzle> puzzle;
+    {
+        std::lock_guard guard(lock);
+        Ring& ring = rings[difficulty];
+        if (ring.count > 0) {
+            puzzle = std::move(ring.entries[ring.head]);
+            ring.entries[ring.head] = {};
+            ring.head = (ring.head + 1) % Depth;
+            --ring.count;
+        }
+    }
+
+    if (puzzle.has_value()) {
+        ++hitCount;
+    } else {
+        ++missCount;
+    }
+
+    wake.notify_one();
+    return puzzle;
+}
+
+void PuzzleQueue::run() {
+    // prefetching isn't what insertion waits on
+    Tracer::markBackground();
+    std::unique_lock guard(lock);
+
+    // stopping is only ever checked and waited on under the lock, so the
+    // destructor's notify can't slip in between
+    while (!stopping) {
+        // refill the emptiest ring first, skipping those that just failed
+        const auto now = std::chrono::steady_clock::now();
+        std::optional<size_t> next;
+        std::optional<std::chrono::steady_clock::time_point> retry;
+        for (size_t i = 0; i < Difficulties; ++i) {
+            const Ring& ring = rings[i];
+            if (ring.count == Depth) {
+                continue;
+            }
+            if (ring.failures > 0 && now < ring.retryAt) {
+                retry = std::min(retry.value_or(ring.retryAt), ring.retryAt);
+                continue;
+            }
+            if (!next.has_value() || ring.count < rings[next.value()].count) {
+                next = i;
+            }
+        }
+
+        if (!next.has_value()) {
+            if (retry.has_value()) {
+                wake.wait_until(guard, retry.value());
+            } else {
+                wake.wait(guard);
+            }
+            continue;
+        }
+
+        const size_t difficulty = next.value();
+        guard.unlock();
+        auto puzzle = builder(static_cast<Sudoku::Difficulty>(difficulty));
+        guard.lock();
+
+        Ring& ring = rings[difficulty];
+        if (!puzzle.has_value()) {
+            // don't spin on a broken difficulty, nor let it starve the others
+            const auto delay = std::min<std::chrono::steady_clock::duration>(
+                RetryDelay * (1u << std::min(ring.failures, 6u)), MaxRetryDelay);
+            ++ring.failures;
+            ring.retryAt = std::chrono::steady_clock::now() + delay;
+            continue;
+        }
+
+        ring.failures = 0;
+        ring.entries[(ring.head + ring.count) % Depth] = std::move(puzzle.value());
+        ++ring.count;
+    }
+}
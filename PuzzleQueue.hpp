@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QList>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "Sudoku.hpp"
+#include "rm_Line.hpp"
+
+// Keeps a few ready-to-draw puzzles per difficulty, refilled on a worker
+// thread so taking one never decodes or tessellates on the UI thread.
+class PuzzleQueue {
+public:
+    // A puzzle along with its hint glyphs and grid.
+    struct Puzzle {
+        Sudoku sudoku;
+        QList<Line> lines;
+        // union of the lines' bounds, all that drawing them touches
+        QRectF bounds;
+    };
+
+    using Builder = std::function<std::optional<Puzzle>(Sudoku::Difficulty)>;
+
+    static constexpr const size_t Depth = 2;
+    static constexpr const size_t Difficulties = 4;
+
+    explicit PuzzleQueue(Builder builder);
+    ~PuzzleQueue();
+
+    // Starts refilling, nothing is built before.
+    void start();
+
+    // std::nullopt if nothing is ready for `level` yet.
+    std::optional<Puzzle> take(Sudoku::Difficulty level);
+
+    uint64_t hits() const { return hitCount; }
+    uint64_t misses() const { return missCount; }
+
+private:
+    struct Ring {
+        std::array<Puzzle, Depth> entries;
+        size_t head = 0;
+        size_t count = 0;
+        // builds failed in a row, and when to try again after the last
+        unsigned failures = 0;
+        std::chrono::steady_clock::time_point retryAt;
+    };
+
+    void run();
+
+    Builder builder;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::array<Ring, Difficulties> rings;
+    bool stopping = false;
+
+    std::atomic<uint64_t> hitCount = 0;
+    std::atomic<uint64_t> missCount = 0;
+
+    std::thread worker;
+};
@@ -0,0 +1,362 @@
+#include "Rater.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+constexpr const uint16_t AllCandidates = 0x1FF;
+constexpr const int RatingBand = 36;
+static_assert(Rater::TechniqueCount * RatingBand <= 256);
+
+constexpr auto generatePeers() {
+    std::array<std::array<uint8_t, 20>, 81> peers{};
+    for (size_t cell = 0; cell < 81; ++cell) {
+        size_t count = 0;
+        for (size_t other = 0; other < 81; ++other) {
+            const bool sameRow = other / 9 == cell / 9;
+            const bool sameColumn = other % 9 == cell % 9;
+            const bool sameBox = other / 27 == cell / 27 && other % 9 / 3 == cell % 9 / 3;
+            if (other != cell && (sameRow || sameColumn || sameBox)) {
+                peers[cell][count++] = static_cast<uint8_t>(other);
+            }
+        }
+    }
+    return peers;
+}
+
+constexpr const auto& Units = Solver::Units;
+constexpr auto Peers = generatePeers();
+
+struct RaterState {
+    Solver::Board cells;
+    // 0 once a cell is filled
+    std::array<uint16_t, 81> candidates;
+    int open;
+    bool broken;
+
+    void place(int cell, int digit) {
+        const uint16_t bit = 1 << (digit - 1);
+        cells[cell] = static_cast<char>(digit);
+        candidates[cell] = 0;
+        --open;
+        for (auto peer : Peers[cell]) {
+            candidates[peer] &= ~bit;
+        }
+    }
+
+    // Removes `mask` from `cell`, whether anything was there to remove.
+    bool eliminate(int cell, uint16_t mask) {
+        if ((candidates[cell] & mask) == 0) {
+            return false;
+        }
+        candidates[cell] &= ~mask;
+        return true;
+    }
+};
+
+static bool setup(RaterState& state, const Solver::Board& givens) {
+    state.cells = {};
+    state.candidates.fill(AllCandidates);
+    state.open = 81;
+    state.broken = false;
+    for (int cell = 0; cell < 81; ++cell) {
+        const int digit = givens[cell];
+        if (digit == 0) {
+            continue;
+        }
+        if (digit < 1 || digit > 9 || !(state.candidates[cell] & (1 << (digit - 1)))) {
+            return false;
+        }
+        state.place(cell, digit);
+    }
+    return true;
+}
+
+static int nakedSingles(RaterState& state) {
+    int found = 0;
+    for (int cell = 0; cell < 81; ++cell) {
+        const uint16_t mask = state.candidates[cell];
+        if (state.cells[cell] != 0) {
+            continue;
+        }
+        if (mask == 0) {
+            state.broken = true;
+            return 0;
+        }
+        if (std::has_single_bit(mask)) {
+            state.place(cell, std::countr_zero(mask) + 1);
+            ++found;
+        }
+    }
+    return found;
+}
+
+static int hiddenSingles(RaterState& state) {
+    int found = 0;
+    for (const auto& unit : Units) {
+        uint16_t once = 0, twice = 0;
+        for (auto cell : unit) {
+            twice |= once & state.candidates[cell];
+            once |= state.candidates[cell];
+        }
+        for (uint16_t exactly = once & ~twice; exactly != 0; exactly &= exactly - 1) {
+            const uint16_t bit = exactly & -exactly;
+            const auto only = std::find_if(unit.begin(), unit.end(), [&](auto cell) {
+                return (state.candidates[cell] & bit) != 0;
+            });
+            if (only == unit.end()) {
+                // an earlier single of this unit filled the one cell left
+                // for this digit too
+                state.broken = true;
+                return 0;
+            }
+            state.place(*only, std::countr_zero(bit) + 1);
+            ++found;
+        }
+    }
+    return found;
+}
+
+// A digit whose candidates in one unit all lie in another unit can't be
+// anywhere else in that other unit.
+static int lockedCandidates(RaterState& state) {
+    int found = 0;
+    for (int box = 0; box < 9; ++box) {
+        const auto& boxCells = Units[18 + box];
+        for (int digit = 0; digit < 9; ++digit) {
+            const uint16_t bit = 1 << digit;
+            uint16_t rows = 0, columns = 0;
+            for (auto cell : boxCells) {
+                if (state.candidates[cell] & bit) {
+                    rows |= 1 << (cell / 9);
+                    columns |= 1 << (cell % 9);
+                }
+            }
+            // pointing
+            bool changed = false;
+            if (std::has_single_bit(rows)) {
+                for (auto cell : Units[std::countr_zero(rows)]) {
+                    if (cell % 9 / 3 != box % 3) {
+                        changed |= state.eliminate(cell, bit);
+                    }
+                }
+            }
+            if (std::has_single_bit(columns)) {
+                for (auto cell : Units[9 + std::countr_zero(columns)]) {
+                    if (cell / 27 != box / 3) {
+                        changed |= state.eliminate(cell, bit);
+                    }
+                }
+            }
+            found += changed;
+        }
+    }
+
+    for (int line = 0; line < 18; ++line) {
+        for (int digit = 0; digit < 9; ++digit) {
+            const uint16_t bit = 1 << digit;
+            uint16_t boxes = 0;
+            for (auto cell : Units[line]) {
+                if (state.candidates[cell] & bit) {
+                    boxes |= 1 << (cell / 27 * 3 + cell % 9 / 3);
+                }
+            }
+            // claiming
+            if (!std::has_single_bit(boxes)) {
+                continue;
+            }
+            bool changed = false;
+            for (auto cell : Units[18 + std::countr_zero(boxes)]) {
+                const bool inLine = line < 9 ? cell / 9 == line : cell % 9 == line - 9;
+                if (!inLine) {
+                    changed |= state.eliminate(cell, bit);
+                }
+            }
+            found += changed;
+        }
+    }
+    return found;
+}
+
+static int nakedPairs(RaterState& state) {
+    int found = 0;
+    for (const auto& unit : Units) {
+        for (int i = 0; i < 9; ++i) {
+            const uint16_t pair = state.candidates[unit[i]];
+            if (std::popcount(pair) != 2) {
+                continue;
+            }
+            for (int j = i + 1; j < 9; ++j) {
+                if (state.candidates[unit[j]] != pair) {
+                    continue;
+                }
+                bool changed = false;
+                for (int k = 0; k < 9; ++k) {
+                    if (k != i && k != j) {
+                        changed |= state.eliminate(unit[k], pair);
+                    }
+                }
+                found += changed;
+            }
+        }
+    }
+    return found;
+}
+
+static int hiddenPairs(RaterState& state) {
+    int found = 0;
+    for (const auto& unit : Units) {
+        // the cells of the unit each digit can go to
+        std::array<uint16_t, 9> places{};
+        for (int i = 0; i < 9; ++i) {
+            for (uint16_t mask = state.candidates[unit[i]]; mask != 0; mask &= mask - 1) {
+                places[std::countr_zero(mask)] |= 1 << i;
+            }
+        }
+        for (int a = 0; a < 9; ++a) {
+            if (std::popcount(places[a]) != 2) {
+                continue;
+            }
+            for (int b = a + 1; b < 9; ++b) {
+                if (places[b] != places[a]) {
+                    continue;
+                }
+                const uint16_t others = AllCandidates & ~((1 << a) | (1 << b));
+                bool changed = false;
+                for (uint16_t cells = places[a]; cells != 0; cells &= cells - 1) {
+                    changed |= state.eliminate(unit[std::countr_zero(cells)], others);
+                }
+                found += changed;
+            }
+        }
+    }
+    return found;
+}
+
+// Rows (or columns) where a digit has the same two possible columns (rows)
+// leave it nowhere else in those columns (rows).
+static int xWings(RaterState& state) {
+    int found = 0;
+    for (int digit = 0; digit < 9; ++digit) {
+        const uint16_t bit = 1 << digit;
+        for (int orientation = 0; orientation < 2; ++orientation) {
+            const int lines = orientation * 9, crossing = 9 - orientation * 9;
+            std::array<uint16_t, 9> places{};
+            for (int line = 0; line < 9; ++line) {
+                for (int i = 0; i < 9; ++i) {
+                    if (state.candidates[Units[lines + line][i]] & bit) {
+                        places[line] |= 1 << i;
+                    }
+                }
+            }
+            for (int a = 0; a < 9; ++a) {
+                if (std::popcount(places[a]) != 2) {
+                    continue;
+                }
+                for (int b = a + 1; b < 9; ++b) {
+                    if (places[b] != places[a]) {
+                        continue;
+                    }
+                    bool changed = false;
+                    for (uint16_t cross = places[a]; cross != 0; cross &= cross - 1) {
+                        const auto& crossLine = Units[crossing + std::countr_zero(cross)];
+                        for (int line = 0; line < 9; ++line) {
+                            if (line != a && line != b) {
+                                changed |= state.eliminate(crossLine[line], bit);
+                            }
+                        }
+                    }
+                    found += changed;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+using Technique = Rater::Technique;
+
+struct Step {
+    Technique technique;
+    int (*apply)(RaterState& state);
+};
+
+constexpr const Step Steps[] = {
+    { Technique::NakedSingle, nakedSingles },
+    { Technique::HiddenSingle, hiddenSingles },
+    { Technique::LockedCandidates, lockedCandidates },
+    { Technique::NakedPair, nakedPairs },
+    { Technique::HiddenPair, hiddenPairs },
+    { Technique::XWing, xWings },
+};
+
+Rater::Rating Rater::rate(const Solver::Board& givens, Solver::Board* filled) {
+    RaterState state;
+    Rating rating = { 0, Technique::NakedSingle, 0, 0 };
+    if (!setup(state, givens)) {
+        state.broken = true;
+    }
+
+    while (state.open > 0 && !state.broken) {
+        bool progressed = false;
+        for (const auto& step : Steps) {
+            const int found = step.apply(state);
+            if (state.broken) {
+                break;
+            }
+            if (found == 0) {
+                continue;
+            }
+
+            rating.steps += found;
+            if (step.technique > rating.hardest) {
+                rating.hardest = step.technique;
+                rating.hardestSteps = 0;
+            }
+            if (step.technique == rating.hardest) {
+                rating.hardestSteps += found;
+            }
+            progressed = true;
+            break;
+        }
+        if (!progressed) {
+            break;
+        }
+    }
+
+    if (filled != nullptr) {
+        *filled = state.cells;
+    }
+    if (state.open > 0 || state.broken) {
+        rating.hardest = Technique::Unsolved;
+        rating.hardestSteps = static_cast<uint16_t>(state.open);
+    }
+    rating.rating = static_cast<uint8_t>(static_cast<int>(rating.hardest) * RatingBand
+        + std::min<int>(rating.hardestSteps, RatingBand - 1));
+    return rating;
+}
+
+Sudoku::Difficulty Rater::difficulty(const Rating& rating) {
+    switch (rating.hardest) {
+    case Technique::NakedSingle:
+        return Sudoku::Difficulty::Easy;
+    case Technique::HiddenSingle:
+        return Sudoku::Difficulty::Medium;
+    case Technique::LockedCandidates:
+    case Technique::NakedPair:
+        return Sudoku::Difficulty::Hard;
+    case Technique::HiddenPair:
+    case Technique::XWing:
+    case Technique::Unsolved:
+        return Sudoku::Difficulty::Expert;
+    }
+    return Sudoku::Difficulty::Expert;
+}
+
+const char* Rater::name(Technique technique) {
+    constexpr const char* Names[] = {
+        "naked single", "hidden single", "locked candidates",
+        "naked pair", "hidden pair", "x-wing", "unsolved",
+    };
+    return Names[static_cast<int>(technique)];
+}
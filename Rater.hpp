@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include "Solver.hpp"
+#include "Sudoku.hpp"
+
+// Grades puzzles by the techniques a person needs to solve them instead of
+// by clue count. Techniques are tried easiest first and every deduction
+// starts over at the singles, so the hardest technique used is one the
+// puzzle can't be solved without, at least by this repertoire.
+class Rater {
+public:
+    // Easiest first.
+    enum class Technique : uint8_t {
+        NakedSingle,
+        HiddenSingle,
+        // pointing and claiming: a digit confined to a box and a line
+        LockedCandidates,
+        NakedPair,
+        HiddenPair,
+        XWing,
+        // needs something beyond the above, chains or guessing
+        Unsolved,
+    };
+    static constexpr const int TechniqueCount = static_cast<int>(Technique::Unsolved) + 1;
+
+    struct Rating {
+        // Banded by `hardest`, then by how often it was needed. Fits the
+        // u8 rating of SUDOKU01 metadata.
+        uint8_t rating;
+        Technique hardest;
+        // deductions made with `hardest`, cells left open when Unsolved
+        uint16_t hardestSteps;
+        uint16_t steps;
+    };
+
+    // `filled`, if given, receives the grid as far as the techniques got.
+    static Rating rate(const Solver::Board& givens, Solver::Board* filled = nullptr);
+    static Rating rate(const Sudoku& sudoku, Solver::Board* filled = nullptr) {
+        return rate(Solver::givens(sudoku), filled);
+    }
+
+    // The pack a puzzle rated `rating` belongs in.
+    static Sudoku::Difficulty difficulty(const Rating& rating);
+    static const char* name(Technique technique);
+};
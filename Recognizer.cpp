@@ -0,0 +1,205 @@
+#include "Recognizer.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "res/digits.hpp"
+
+// Enough to tell the glyphs apart, few enough that matching all nine
+// templates stays well below a millisecond on the tablet.
+constexpr const size_t SamplePoints = 32;
+// Starting points tried per match, every sqrt(SamplePoints)th point.
+constexpr const size_t MatchStep = 5;
+// Mean point distance, relative to the larger side of the bounding box,
+// above which strokes are not considered a digit at all.
+constexpr const float MaxDistance = 0.11f;
+// Strokes narrower than this relative to their height are a plain 1,
+// which the flagged glyph doesn't match well.
+constexpr const float BarRatio = 0.25f;
+
+struct Point {
+    float x;
+    float y;
+};
+
+using Cloud = std::array<Point, SamplePoints>;
+
+// Walks all strokes as one path, without the jumps between them, and
+// emits SamplePoints equally spaced points along it.
+template <typename Stroke>
+static std::optional<Cloud> resample(std::span<const Stroke> strokes) {
+    float length = 0.0f;
+    for (const auto& stroke : strokes) {
+        for (size_t i = 1; i < static_cast<size_t>(stroke.size()); ++i) {
+            length += std::hypot(stroke[i].x - stroke[i - 1].x, stroke[i].y - stroke[i - 1].y);
+        }
+    }
+    if (length <= 0.0f) {
+        return std::nullopt;
+    }
+
+    const float interval = length / (SamplePoints - 1);
+    Cloud cloud;
+    size_t count = 0;
+    float walked = 0.0f;
+
+    for (const auto& stroke : strokes) {
+        if (stroke.size() == 0) {
+            continue;
+        }
+        Point previous = {stroke[0].x, stroke[0].y};
+        if (count == 0) {
+            cloud[count++] = previous;
+        }
+        for (size_t i = 1; i < static_cast<size_t>(stroke.size()) && count < SamplePoints; ++i) {
+            const Point current = {stroke[i].x, stroke[i].y};
+            float distance = std::hypot(current.x - previous.x, current.y - previous.y);
+            while (walked + distance >= interval && count < SamplePoints) {
+                const float t = (interval - walked) / distance;
+                previous = {
+                    previous.x + t * (current.x - previous.x),
+                    previous.y + t * (current.y - previous.y)};
+                cloud[count++] = previous;
+                distance = std::hypot(current.x - previous.x, current.y - previous.y);
+                walked = 0.0f;
+            }
+            walked += distance;
+            previous = current;
+        }
+    }
+
+    // rounding may leave the last point short
+    while (count < SamplePoints) {
+        cloud[count] = cloud[count - 1];
+        ++count;
+    }
+    return cloud;
+}
+
+// Scales the cloud uniformly into the unit box and centers it on its
+// centroid. Returns the width to height ratio of the original.
+static std::optional<float> normalize(Cloud& cloud) {
+    float minX = cloud[0].x, maxX = cloud[0].x;
+    float minY = cloud[0].y, maxY = cloud[0].y;
+    for (const auto& point : cloud) {
+        minX = std::min(minX, point.x);
+        maxX = std::max(maxX, point.x);
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+
+    const float width = maxX - minX;
+    const float height = maxY - minY;
+    const float size = std::max(width, height);
+    if (size <= 0.0f) {
+        return std::nullopt;
+    }
+
+    float centerX = 0.0f, centerY = 0.0f;
+    for (auto& point : cloud) {
+        point.x = (point.x - minX) / size;
+        point.y = (point.y - minY) / size;
+        centerX += point.x;
+        centerY += point.y;
+    }
+    centerX /= SamplePoints;
+    centerY /= SamplePoints;
+    for (auto& point : cloud) {
+        point.x -= centerX;
+        point.y -= centerY;
+    }
+    return width / height;
+}
+
+// Greedily pairs every point of `from`, starting at `start`, with the
+// nearest unpaired point of `to`. Earlier pairs weigh more since they had
+// more to choose from. Gives up once the sum exceeds `limit`.
+static float cloudDistance(const Cloud& from, const Cloud& to, size_t start, float limit) {
+    std::array<bool, SamplePoints> paired{};
+    float sum = 0.0f;
+    size_t i = start;
+
+    for (size_t step = 0; step < SamplePoints; ++step) {
+        float nearest = std::numeric_limits<float>::max();
+        size_t index = 0;
+        for (size_t j = 0; j < SamplePoints; ++j) {
+            if (paired[j]) {
+                continue;
+            }
+            const float dx = from[i].x - to[j].x;
+            const float dy = from[i].y - to[j].y;
+            const float distance = dx * dx + dy * dy;
+            if (distance < nearest) {
+                nearest = distance;
+                index = j;
+            }
+        }
+        paired[index] = true;
+
+        const float weight = 1.0f - static_cast<float>(step) / SamplePoints;
+        sum += weight * std::sqrt(nearest);
+        if (sum >= limit) {
+            return sum;
+        }
+        i = (i + 1) % SamplePoints;
+    }
+    return sum;
+}
+
+static float matchDistance(const Cloud& candidate, const Cloud& glyph, float limit) {
+    float best = limit;
+    for (size_t start = 0; start < SamplePoints; start += MatchStep) {
+        best = std::min(best, cloudDistance(candidate, glyph, start, best));
+        best = std::min(best, cloudDistance(glyph, candidate, start, best));
+    }
+    return best;
+}
+
+static std::array<Cloud, 9> buildGlyphClouds() {
+    std::array<Cloud, 9> clouds;
+    for (size_t digit = 0; digit < 9; ++digit) {
+        // glyphs have y pointing up, strokes down
+        std::vector<Coordinate> glyph(DigitPoints[digit].begin(), DigitPoints[digit].end());
+        for (auto& point : glyph) {
+            point.y = -point.y;
+        }
+        const std::span<const Coordinate> stroke(glyph);
+        clouds[digit] = resample(std::span(&stroke, 1)).value();
+        normalize(clouds[digit]);
+    }
+    return clouds;
+}
+
+std::optional<Recognizer::Match> Recognizer::recognize(std::span<const QList<LinePoint>> strokes) {
+    static const std::array<Cloud, 9> glyphClouds = buildGlyphClouds();
+
+    auto cloud = resample(strokes);
+    if (!cloud.has_value()) {
+        return std::nullopt;
+    }
+    auto ratio = normalize(cloud.value());
+    if (!ratio.has_value()) {
+        return std::nullopt;
+    }
+    if (ratio.value() < BarRatio) {
+        return Match{1, 0.0f};
+    }
+
+    // sum of the weights in cloudDistance, turns sums into means
+    constexpr const float WeightSum = (SamplePoints + 1) / 2.0f;
+
+    float best = MaxDistance * WeightSum;
+    int digit = 0;
+    for (size_t i = 0; i < glyphClouds.size(); ++i) {
+        const float distance = matchDistance(cloud.value(), glyphClouds[i], best);
+        if (distance < best) {
+            best = distance;
+            digit = static_cast<int>(i) + 1;
+        }
+    }
+    if (digit == 0) {
+        return std::nullopt;
+    }
+    return Match{digit, best / WeightSum};
+}
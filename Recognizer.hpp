@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QList>
+#include <optional>
+#include <span>
+#include "rm_Line.hpp"
+
+// Matches handwritten strokes against the DigitPoints glyphs. Strokes
+// and glyphs are resampled into equally spaced point clouds, so stroke
+// order, direction and count don't matter, only the shape.
+class Recognizer {
+public:
+    struct Match {
+        int digit;
+        // mean distance between matched points in the normalized box
+        float distance;
+    };
+
+    // Best matching digit for strokes written into one cell, if any is
+    // close enough.
+    static std::optional<Match> recognize(std::span<const QList<LinePoint>> strokes);
+};
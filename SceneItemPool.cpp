@@ -0,0 +1,66 @@
+#include "SceneItemPool.hpp"
+
+#include <new>
+#include "rm_SceneLineItem.hpp"
+
+struct SceneItemPool::Arena {
+    explicit Arena(size_t count) : count(count) {}
+    ~Arena() { ::operator delete(block); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size) {
+        // the first request tells how large allocate_shared's blocks are
+        if (block == nullptr) {
+            slot = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+            block = static_cast<std::byte*>(::operator new(slot * count));
+        }
+        if (size > slot || used == count) {
+            return ::operator new(size);
+        }
+        return block + slot * used++;
+    }
+
+    void deallocate(void* pointer, size_t size) {
+        // slots aren't reused, the block goes as a whole
+        if (pointer < block || pointer >= block + slot * count) {
+            ::operator delete(pointer, size);
+        }
+    }
+
+    const size_t count;
+    std::byte* block = nullptr;
+    size_t slot = 0;
+    size_t used = 0;
+};
+
+// Keeps the arena alive from inside every control block it allocated.
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    explicit PoolAllocator(std::shared_ptr<SceneItemPool::Arena> arena) : arena(std::move(arena)) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+        return static_cast<T*>(arena->allocate(n * sizeof(T)));
+    }
+    void deallocate(T* pointer, size_t n) { arena->deallocate(pointer, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return arena == other.arena; }
+
+    std::shared_ptr<SceneItemPool::Arena> arena;
+};
+
+SceneItemPool::SceneItemPool(size_t count)
+    : arena(std::make_shared<Arena>(count)) {
+}
+
+std::shared_ptr<SceneItem> SceneItemPool::make(Line&& line) {
+    return std::allocate_shared<SceneLineItem>(
+        PoolAllocator<SceneLineItem>(arena), SceneLineItem::fromLine(std::move(line)));
+}
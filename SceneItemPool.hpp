@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "rm_SceneItem.hpp"
+#include "rm_Line.hpp"
+
+// Hands out the SceneLineItems of one clipboard batch, control blocks
+// included, from a single block instead of one allocation per item.
+// xochitl owns the items once they are pasted, so the block stays alive
+// until the last of them is released, however long after the batch that is.
+class SceneItemPool {
+public:
+    // Items beyond `count` are allocated on their own.
+    explicit SceneItemPool(size_t count);
+
+    std::shared_ptr<SceneItem> make(Line&& line);
+
+private:
+    template <typename T>
+    friend struct PoolAllocator;
+    struct Arena;
+    std::shared_ptr<Arena> arena;
+};
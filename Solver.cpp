@@ -0,0 +1,235 @@
+#include "Solver.hpp"
+
+#include <bit>
+#include <cstdint>
+
+constexpr const uint16_t AllCandidates = 0x1FF;
+
+constexpr auto generateBoxIndices() {
+    std::array<uint8_t, 81> boxes{};
+    for (size_t i = 0; i < 81; ++i) {
+        boxes[i] = static_cast<uint8_t>((i / 27) * 3 + (i % 9) / 3);
+    }
+    return boxes;
+}
+
+constexpr auto BoxIndex = generateBoxIndices();
+
+struct SolverState {
+    uint16_t rows[9];
+    uint16_t columns[9];
+    uint16_t boxes[9];
+    Solver::Board cells;
+
+    // cells still to be filled, [0, emptyCount)
+    uint8_t empty[81];
+    uint8_t position[81];
+    int emptyCount;
+
+    constexpr uint16_t candidates(size_t cell) const {
+        return ~(rows[cell / 9] | columns[cell % 9] | boxes[BoxIndex[cell]]) & AllCandidates;
+    }
+
+    constexpr void place(int emptyIndex, uint16_t bit) {
+        const size_t cell = empty[emptyIndex];
+        rows[cell / 9] |= bit;
+        columns[cell % 9] |= bit;
+        boxes[BoxIndex[cell]] |= bit;
+        cells[cell] = static_cast<char>(std::countr_zero(bit) + 1);
+        empty[emptyIndex] = empty[--emptyCount];
+        position[empty[emptyIndex]] = static_cast<uint8_t>(emptyIndex);
+    }
+};
+
+static bool setup(SolverState& state, const Solver::Board& cells) {
+    state = {};
+    state.cells = cells;
+
+    for (size_t i = 0; i < 81; ++i) {
+        int digit = cells[i];
+        if (digit == 0) {
+            state.position[i] = static_cast<uint8_t>(state.emptyCount);
+            state.empty[state.emptyCount++] = static_cast<uint8_t>(i);
+            continue;
+        }
+        if (digit < 1 || digit > 9) {
+            return false;
+        }
+
+        uint16_t bit = 1 << (digit - 1);
+        if (!(state.candidates(i) & bit)) {
+            // the clues already contradict each other
+            return false;
+        }
+        state.rows[i / 9] |= bit;
+        state.columns[i % 9] |= bit;
+        state.boxes[BoxIndex[i]] |= bit;
+    }
+    return true;
+}
+
+// Places every digit that is the only candidate of its cell or the only
+// position left for it in a unit. Returns false on a contradiction.
+static bool propagate(SolverState& state) {
+    bool progress = true;
+    while (progress && state.emptyCount > 0) {
+        progress = false;
+
+        for (int i = 0; i < state.emptyCount;) {
+            uint16_t candidates = state.candidates(state.empty[i]);
+            if (candidates == 0) {
+                return false;
+            }
+            if (std::has_single_bit(candidates)) {
+                state.place(i, candidates);
+                progress = true;
+                continue;
+            }
+            ++i;
+        }
+
+        if (progress || state.emptyCount == 0) {
+            continue;
+        }
+
+        uint16_t cellCandidates[81] = {};
+        for (int i = 0; i < state.emptyCount; ++i) {
+            cellCandidates[state.empty[i]] = state.candidates(state.empty[i]);
+        }
+
+        for (const auto& unit : Solver::Units) {
+            uint16_t once = 0;
+            uint16_t twice = 0;
+            uint16_t placed = 0;
+            for (auto cell : unit) {
+                const uint16_t candidates = cellCandidates[cell];
+                twice |= once & candidates;
+                once |= candidates;
+                if (state.cells[cell]) {
+                    placed |= 1 << (state.cells[cell] - 1);
+                }
+            }
+
+            if ((once | placed) != AllCandidates) {
+                // some digit has nowhere left to go
+                return false;
+            }
+
+            uint16_t hidden = once & ~twice & ~placed;
+            for (auto cell : unit) {
+                const uint16_t bit = cellCandidates[cell] & hidden;
+                if (!bit) {
+                    continue;
+                }
+                // candidates are stale once something was placed
+                if (!std::has_single_bit(bit) || !(state.candidates(cell) & bit)) {
+                    return false;
+                }
+                cellCandidates[cell] = 0;
+                state.place(state.position[cell], bit);
+                progress = true;
+            }
+        }
+    }
+    return true;
+}
+
+struct SearchContext {
+    int found;
+    int limit;
+    Solver::Board* solution;
+    // xorshift state, branches in ascending digit order when zero
+    uint32_t random;
+};
+
+static uint16_t nextBranch(SearchContext& context, uint16_t candidates) {
+    if (!context.random) {
+        return candidates & -candidates;
+    }
+
+    context.random ^= context.random << 13;
+    context.random ^= context.random >> 17;
+    context.random ^= context.random << 5;
+
+    for (int skip = context.random % std::popcount(candidates); skip > 0; --skip) {
+        candidates &= candidates - 1;
+    }
+    return candidates & -candidates;
+}
+
+static void search(SolverState state, SearchContext& context) {
+    if (!propagate(state)) {
+        return;
+    }
+
+    if (state.emptyCount == 0) {
+        if (context.found++ == 0 && context.solution) {
+            *context.solution = state.cells;
+        }
+        return;
+    }
+
+    // most constrained cell first
+    int best = 0;
+    int bestCount = 10;
+    uint16_t bestCandidates = 0;
+    for (int i = 0; i < state.emptyCount; ++i) {
+        uint16_t candidates = state.candidates(state.empty[i]);
+        int count = std::popcount(candidates);
+        if (count < bestCount) {
+            best = i;
+            bestCount = count;
+            bestCandidates = candidates;
+            if (count <= 2) {
+                break;
+            }
+        }
+    }
+
+    while (bestCandidates && context.found < context.limit) {
+        uint16_t bit = nextBranch(context, bestCandidates);
+        bestCandidates ^= bit;
+
+        SolverState next = state;
+        next.place(best, bit);
+        search(next, context);
+    }
+}
+
+std::optional<Solver::Board> Solver::solve(const Board& cells) {
+    return solveRandom(cells, 0);
+}
+
+std::optional<Solver::Board> Solver::solveRandom(const Board& cells, uint32_t seed) {
+    SolverState state;
+    if (!setup(state, cells)) {
+        return std::nullopt;
+    }
+
+    Board solution;
+    SearchContext context = { 0, 1, &solution, seed };
+    search(state, context);
+    if (context.found == 0) {
+        return std::nullopt;
+    }
+    return solution;
+}
+
+int Solver::countSolutions(const Board& cells, int limit) {
+    SolverState state;
+    if (!setup(state, cells)) {
+        return 0;
+    }
+
+    SearchContext context = { 0, limit, nullptr, 0 };
+    search(state, context);
+    return context.found;
+}
+
+Solver::Board Solver::givens(const Sudoku& sudoku) {
+    Board cells{};
+    for (size_t i = 0; i < 81; ++i) {
+        cells[i] = sudoku.HintMask[i] ? sudoku.Number[i] : 0;
+    }
+    return cells;
+}
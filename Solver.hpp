@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "Sudoku.hpp"
+
+// The cells of every unit: rows, then columns, then boxes.
+constexpr auto generateUnits() {
+    std::array<std::array<uint8_t, 9>, 27> units{};
+    for (size_t i = 0; i < 9; ++i) {
+        for (size_t j = 0; j < 9; ++j) {
+            units[i][j] = static_cast<uint8_t>(i * 9 + j);
+            units[9 + i][j] = static_cast<uint8_t>(j * 9 + i);
+            units[18 + i][j] = static_cast<uint8_t>((i / 3) * 27 + (i % 3) * 3 + (j / 3) * 9 + (j % 3));
+        }
+    }
+    return units;
+}
+
+// Backtracking solver over per-row/column/box candidate bitmasks.
+// Boards hold 0 for an empty cell and 1-9 for a placed digit.
+class Solver {
+public:
+    using Board = std::array<char, 81>;
+    static constexpr auto Units = generateUnits();
+
+    static std::optional<Board> solve(const Board& cells);
+    // Like solve(), but tries digits in an order derived from `seed` so
+    // an empty board yields a random complete grid.
+    static std::optional<Board> solveRandom(const Board& cells, uint32_t seed);
+    // Stops searching once `limit` solutions have been found.
+    static int countSolutions(const Board& cells, int limit = 2);
+    static bool hasUniqueSolution(const Board& cells) {
+        return countSolutions(cells, 2) == 1;
+    }
+
+    // The clues of a decoded puzzle, i.e. Number masked by HintMask.
+    static Board givens(const Sudoku& sudoku);
+};
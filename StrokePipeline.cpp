@@ -0,0 +1,78 @@
+#include "StrokePipeline.hpp"
+
+#include <algorithm>
+#include "Tracer.hpp"
+
+StrokePipeline::StrokePipeline(Handler handler)
+    : handler(std::move(handler)),
+      worker(&StrokePipeline::run, this) {
+}
+
+StrokePipeline::~StrokePipeline() {
+    stopping = true;
+    ++wakeups;
+    wakeups.notify_one();
+    worker.join();
+}
+
+bool StrokePipeline::push(const Line& line) {
+    const size_t position = tail.load(std::memory_order_relaxed);
+    const size_t depth = position - head.load(std::memory_order_acquire);
+    if (depth == Capacity) {
+        ++dropCount;
+        return false;
+    }
+
+    Slot& slot = ring[position % Capacity];
+    const size_t count = static_cast<size_t>(line.points.size());
+    const size_t stride = std::max<size_t>((count + MaxPoints - 1) / MaxPoints, 1);
+    slot.enqueued = Tracer::now();
+    slot.count = 0;
+    for (size_t i = 0; i < count; i += stride) {
+        slot.points[slot.count++] = line.points[i];
+    }
+
+    tail.store(position + 1, std::memory_order_release);
+    ++pushCount;
+
+    size_t seen = maxDepthSeen.load(std::memory_order_relaxed);
+    while (depth + 1 > seen && !maxDepthSeen.compare_exchange_weak(seen, depth + 1)) {
+    }
+
+    ++wakeups;
+    wakeups.notify_one();
+    return true;
+}
+
+void StrokePipeline::recordResult(uint64_t enqueued) {
+    const uint64_t latency = Tracer::now() - enqueued;
+    ++resultCount;
+    latencySum += latency;
+
+    uint64_t seen = latencyMax.load(std::memory_order_relaxed);
+    while (latency > seen && !latencyMax.compare_exchange_weak(seen, latency)) {
+    }
+
+    if (Tracer::enabled()) {
+        Tracer::record(Tracer::Phase::StrokeLatency, latency);
+    }
+}
+
+void StrokePipeline::run() {
+    while (true) {
+        const uint32_t seen = wakeups.load(std::memory_order_acquire);
+        const size_t position = head.load(std::memory_order_relaxed);
+
+        if (position == tail.load(std::memory_order_acquire)) {
+            if (stopping) {
+                return;
+            }
+            wakeups.wait(seen);
+            continue;
+        }
+
+        const Slot& slot = ring[position % Capacity];
+        handler(Stroke{slot.enqueued, std::span(slot.points.data(), slot.count)});
+        head.store(position + 1, std::memory_order_release);
+    }
+}
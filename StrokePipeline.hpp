@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+#include "rm_Line.hpp"
+
+// Hands completed strokes from the pen input thread to a worker through
+// a preallocated single producer, single consumer ring. Pushing copies
+// the points into a free slot and never blocks or allocates; strokes
+// are dropped while the ring is full.
+class StrokePipeline {
+public:
+    // A digit written into a cell is well below this, longer strokes
+    // keep every n-th point.
+    static constexpr const size_t MaxPoints = 512;
+    static constexpr const size_t Capacity = 16;
+
+    struct Stroke {
+        // Tracer::now() when it was pushed
+        uint64_t enqueued;
+        std::span<const LinePoint> points;
+    };
+
+    // Called on the worker for every stroke, in order.
+    using Handler = std::function<void(const Stroke&)>;
+
+    explicit StrokePipeline(Handler handler);
+    ~StrokePipeline();
+
+    // Producer side, false if the stroke was dropped.
+    bool push(const Line& line);
+
+    // Closes the loop for a stroke pushed at `enqueued`, from any thread.
+    void recordResult(uint64_t enqueued);
+
+    size_t depth() const { return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed); }
+    size_t maxDepth() const { return maxDepthSeen; }
+    uint64_t pushed() const { return pushCount; }
+    uint64_t dropped() const { return dropCount; }
+    uint64_t results() const { return resultCount; }
+    // Enqueue to result, in nanoseconds.
+    uint64_t meanLatency() const { return resultCount ? latencySum / resultCount : 0; }
+    uint64_t maxLatency() const { return latencyMax; }
+
+private:
+    struct Slot {
+        uint64_t enqueued;
+        size_t count;
+        std::array<LinePoint, MaxPoints> points;
+    };
+
+    void run();
+
+    Handler handler;
+    std::array<Slot, Capacity> ring;
+
+    // free running, the slot is the index modulo Capacity
+    alignas(64) std::atomic<size_t> head = 0;
+    alignas(64) std::atomic<size_t> tail = 0;
+    // bumped on every push, the worker sleeps on it while the ring is empty
+    std::atomic<uint32_t> wakeups = 0;
+    std::atomic<bool> stopping = false;
+
+    std::atomic<size_t> maxDepthSeen = 0;
+    std::atomic<uint64_t> pushCount = 0;
+    std::atomic<uint64_t> dropCount = 0;
+    std::atomic<uint64_t> resultCount = 0;
+    std::atomic<uint64_t> latencySum = 0;
+    std::atomic<uint64_t> latencyMax = 0;
+
+    std::thread worker;
+};
@@ -0,0 +1,177 @@
+#include "StrokeRecorder.hpp"
+
+#include <QFile>
+#include <chrono>
+#include <cstring>
+#include "Tracer.hpp"
+
+constexpr const char MAGIC[8] = { 'S', 'T', 'R', 'O', 'K', 'E', '0', '0' };
+constexpr const size_t STROKE_HEADER_SIZE = 0x44;
+// written out early once this full
+constexpr const size_t BUFFER_SIZE = 64 * 1024;
+// strokes are written at most this long after they were made
+constexpr const auto FLUSH_DELAY = std::chrono::milliseconds(500);
+
+template <typename T>
+static unsigned char* put(unsigned char* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+}
+
+template <typename T>
+static T get(const unsigned char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+bool StrokeRecorder::open(const char* path) {
+    close();
+
+    file = fopen(path, "ab");
+    if (file == nullptr) {
+        printf("Failed to open stroke recording: %s\n", path);
+        return false;
+    }
+    // the buffer below is all the buffering needed
+    setvbuf(file, nullptr, _IONBF, 0);
+
+    buffer.reserve(BUFFER_SIZE);
+    if (ftell(file) == 0) {
+        buffer.insert(buffer.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    }
+    start = Tracer::now();
+    firstBuffered = start;
+    count = 0;
+    stopping = false;
+    writer = std::thread(&StrokeRecorder::run, this);
+    return true;
+}
+
+void StrokeRecorder::close() {
+    if (file == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void StrokeRecorder::record(const Line& line) {
+    if (file == nullptr) {
+        return;
+    }
+
+    const size_t points = static_cast<size_t>(line.points.size());
+    const size_t size = STROKE_HEADER_SIZE + points * sizeof(LinePoint);
+    const uint64_t now = Tracer::now();
+
+    std::unique_lock guard(lock);
+    const size_t offset = buffer.size();
+    if (offset == 0) {
+        firstBuffered = now;
+    }
+    buffer.resize(offset + size);
+    unsigned char* out = buffer.data() + offset;
+    out = put<uint64_t>(out, now - start);
+    out = put<int32_t>(out, line.tool);
+    out = put<int32_t>(out, line.color);
+    out = put<uint32_t>(out, line.rgba);
+    out = put<float>(out, line.thickness);
+    out = put<double>(out, line.maskScale);
+    out = put<double>(out, line.bounds.x());
+    out = put<double>(out, line.bounds.y());
+    out = put<double>(out, line.bounds.width());
+    out = put<double>(out, line.bounds.height());
+    out = put<uint32_t>(out, static_cast<uint32_t>(points));
+    std::memcpy(out, line.points.constData(), points * sizeof(LinePoint));
+    const bool wakeWriter = offset == 0 || buffer.size() >= BUFFER_SIZE;
+    guard.unlock();
+
+    ++count;
+    if (wakeWriter) {
+        wake.notify_one();
+    }
+}
+
+void StrokeRecorder::run() {
+    std::vector<unsigned char> writing;
+    writing.reserve(BUFFER_SIZE);
+
+    std::unique_lock guard(lock);
+    while (true) {
+        wake.wait(guard, [this] { return stopping || !buffer.empty(); });
+        if (!stopping && buffer.size() < BUFFER_SIZE) {
+            // give the rest of the stroke group a moment to join in
+            // Tracer::now is steady_clock
+            const auto deadline = std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(firstBuffered)) + FLUSH_DELAY;
+            wake.wait_until(guard, deadline, [this] { return stopping || buffer.size() >= BUFFER_SIZE; });
+        }
+
+        std::swap(writing, buffer);
+        const bool last = stopping;
+        guard.unlock();
+        if (!writing.empty() && fwrite(writing.data(), 1, writing.size(), file) != writing.size()) {
+            printf("Failed to write stroke recording\n");
+        }
+        writing.clear();
+        if (last) {
+            return;
+        }
+        guard.lock();
+    }
+}
+
+std::optional<std::vector<StrokeRecorder::Stroke>> StrokeRecorder::load(const char* path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printf("Failed to open stroke recording: %s\n", path);
+        return std::nullopt;
+    }
+
+    const qint64 size = file.size();
+    const uchar* data = size > 0 ? file.map(0, size) : nullptr;
+    if (data == nullptr || static_cast<size_t>(size) < sizeof(MAGIC)
+        || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        printf("Not a stroke recording: %s\n", path);
+        return std::nullopt;
+    }
+
+    std::vector<Stroke> strokes;
+    const uchar* end = data + size;
+    const uchar* in = data + sizeof(MAGIC);
+    while (in < end) {
+        if (static_cast<size_t>(end - in) < STROKE_HEADER_SIZE) {
+            printf("Truncated stroke recording: %s\n", path);
+            break;
+        }
+
+        const uint32_t points = get<uint32_t>(in + 0x40);
+        if (static_cast<size_t>(end - in - STROKE_HEADER_SIZE) < points * sizeof(LinePoint)) {
+            printf("Truncated stroke recording: %s\n", path);
+            break;
+        }
+
+        Line line = {};
+        line.tool = get<int32_t>(in + 0x08);
+        line.color = get<int32_t>(in + 0x0c);
+        line.rgba = get<uint32_t>(in + 0x10);
+        line.thickness = get<float>(in + 0x14);
+        line.maskScale = get<double>(in + 0x18);
+        line.bounds = QRectF(
+            get<double>(in + 0x20), get<double>(in + 0x28),
+            get<double>(in + 0x30), get<double>(in + 0x38));
+        line.points.resize(points);
+        std::memcpy(line.points.data(), in + STROKE_HEADER_SIZE, points * sizeof(LinePoint));
+
+        strokes.push_back(Stroke{get<uint64_t>(in), std::move(line)});
+        in += STROKE_HEADER_SIZE + points * sizeof(LinePoint);
+    }
+    return strokes;
+}
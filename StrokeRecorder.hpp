@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "rm_Line.hpp"
+
+// Captures completed strokes into a compact binary file that can be
+// replayed on the host. Records are copied into a buffer as they are,
+// nothing is formatted per point, and a writer thread writes the buffer
+// out shortly after the first stroke in it. A session that ends without
+// close() loses at most that last moment of strokes.
+//
+// Layout, little endian:
+//   0x00  char[8]  "STROKE00", only at the start of the file
+//   per stroke:
+//   0x00  u64      nanoseconds since recording started
+//   0x08  i32      tool
+//   0x0c  i32      color
+//   0x10  u32      rgba
+//   0x14  f32      thickness
+//   0x18  f64      mask scale
+//   0x20  f64[4]   bounds x, y, width, height
+//   0x40  u32      point count
+//   0x44  LinePoint[count], 14 bytes each
+// Recording into an existing file appends another session to it.
+class StrokeRecorder {
+public:
+    struct Stroke {
+        uint64_t timestamp;
+        Line line;
+    };
+
+    StrokeRecorder() = default;
+    ~StrokeRecorder() { close(); }
+
+    StrokeRecorder(const StrokeRecorder&) = delete;
+    StrokeRecorder& operator=(const StrokeRecorder&) = delete;
+
+    bool open(const char* path);
+    // Writes whatever is still buffered.
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    size_t recorded() const { return count; }
+
+    void record(const Line& line);
+
+    // Every stroke of every session in the file, or std::nullopt if it
+    // isn't a stroke recording.
+    static std::optional<std::vector<Stroke>> load(const char* path);
+
+private:
+    void run();
+
+    FILE* file = nullptr;
+    uint64_t start = 0;
+    size_t count = 0;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    // strokes not written yet, and when the first of them came in
+    std::vector<unsigned char> buffer;
+    uint64_t firstBuffered = 0;
+    bool stopping = false;
+    std::thread writer;
+};
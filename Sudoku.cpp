@@ -1,11 +1,30 @@
 #include "Sudoku.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <QResource>
 #include <QFile>
 #include <QRandomGenerator>
+#include "BlockPack.hpp"
+#include "Crc32.hpp"
+#include "PlayedSet.hpp"
+#include "Tracer.hpp"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 constexpr const uchar HEADER[8] = { 'S', 'U', 'D', 'O', 'K', 'U', '0', '0' };
+constexpr const uchar HEADER_V1[8] = { 'S', 'U', 'D', 'O', 'K', 'U', '0', '1' };
+constexpr const uchar HEADER_V2[8] = { 'S', 'U', 'D', 'O', 'K', 'U', '0', '2' };
 constexpr const size_t CELL_COUNT = 81;
 constexpr const size_t PUZZLE_SIZE = static_cast<size_t>(CELL_COUNT / 2) + 1;
 constexpr const size_t HINT_SIZE = static_cast<size_t>(CELL_COUNT / 8) + 1;
@@ -15,26 +34,197 @@ static_assert(PUZZLE_SIZE == 41);
 static_assert(HINT_SIZE == 11);
 static_assert(ELEMENT_SIZE == 52);
 
-static constexpr std::optional<Sudoku> load(
+// SUDOKU01, see res/README.md
+constexpr const size_t HEADER_V1_SIZE = 0x14;
+constexpr const size_t TOC_ENTRY_SIZE = 0x10;
+constexpr const size_t METADATA_SIZE = 8;
+constexpr const size_t RATING_INDEX_SIZE = 257 * 4;
+constexpr const uchar FLAG_METADATA = 0x01;
+constexpr const size_t MAX_PARTITIONS = 4;
+
+constexpr const char* RESOURCE_PATH = ":/bin/res/puzzles.bin";
+
+static constexpr uint32_t readU32(const uchar* data) {
+    return
+        static_cast<uint32_t>(data[0]) |
+        (static_cast<uint32_t>(data[1]) << 8) |
+        (static_cast<uint32_t>(data[2]) << 16) |
+        (static_cast<uint32_t>(data[3]) << 24);
+}
+
+struct Partition {
+    uint32_t first;
+    uint32_t count;
+    // tells partitions with other puzzles apart
+    uint32_t checksum;
+    // 257 record offsets into the partition, one per rating, nullptr without metadata
+    const uchar* ratingIndex;
+};
+
+struct Pack {
+    // nullptr for SUDOKU02, whose records are in `blocks`
+    const uchar* records;
+    BlockPack blocks;
+    // METADATA_SIZE bytes per record, nullptr without metadata
+    const uchar* metadata;
+    uint32_t count;
+    // indexed by Sudoku::Difficulty, SUDOKU00 files have no partitions
+    std::array<Partition, MAX_PARTITIONS> partitions;
+};
+
+// SUDOKU01, or SUDOKU02 when `compressed`, which only differ in how the
+// records are stored.
+static constexpr std::optional<Pack> validateV1(
     const uchar* data,
     const size_t size,
-    std::optional<int> index = std::nullopt) {
+    const bool compressed) {
+    if (size < HEADER_V1_SIZE) {
+        printf("Invalid Sudoku file: %zu bytes\n", size);
+        return std::nullopt;
+    }
+
+    const uint32_t count = readU32(data + 8);
+    const size_t partitionCount = data[12];
+    const bool hasMetadata = data[13] & FLAG_METADATA;
+    const uint32_t perBlock = static_cast<uint32_t>(data[14]) | static_cast<uint32_t>(data[15]) << 8;
+
+    if (partitionCount > MAX_PARTITIONS || size < HEADER_V1_SIZE + partitionCount * TOC_ENTRY_SIZE) {
+        printf("Invalid Sudoku file: bad table of contents\n");
+        return std::nullopt;
+    }
+
+    const uchar* toc = data + HEADER_V1_SIZE;
+    const uint32_t tocCrc = crc32(toc, partitionCount * TOC_ENTRY_SIZE, crc32(data, 0x10));
+    if (tocCrc != readU32(data + 0x10)) {
+        printf("Invalid Sudoku file: table of contents checksum mismatch\n");
+        return std::nullopt;
+    }
+
+    // 64 bit so ten million records do not overflow on arm
+    const uint64_t recordsOffset = HEADER_V1_SIZE + partitionCount * TOC_ENTRY_SIZE;
+    uint64_t recordsSize = static_cast<uint64_t>(count) * ELEMENT_SIZE;
+
+    Pack pack = {};
+    pack.count = count;
+    if (compressed) {
+        // block offsets and checksums, then the blocks. Each block is only
+        // checked when it's decoded, opening doesn't touch them.
+        const BlockPack blocks = { data + recordsOffset, nullptr, nullptr, count, perBlock };
+        const uint64_t blockCount = perBlock == 0 ? 0 : blocks.blockCount();
+        const uint64_t indexSize = (blockCount + 1) * 4 + blockCount * 4;
+        if (perBlock == 0 || size < recordsOffset + indexSize || readU32(blocks.offsets) != 0) {
+            printf("Invalid Sudoku file: bad block index\n");
+            return std::nullopt;
+        }
+
+        recordsSize = indexSize + readU32(blocks.offsets + blockCount * 4);
+        if (size < recordsOffset + recordsSize) {
+            printf("Invalid Sudoku file: %u puzzles do not fit in %zu bytes\n", count, size);
+            return std::nullopt;
+        }
+        pack.blocks = blocks;
+        pack.blocks.checksums = blocks.offsets + (blockCount + 1) * 4;
+        pack.blocks.blocks = data + recordsOffset + indexSize;
+    } else {
+        pack.records = data + recordsOffset;
+    }
+
+    const uint64_t required = recordsOffset + recordsSize
+        + static_cast<uint64_t>(count) * (hasMetadata ? METADATA_SIZE : 0)
+        + (hasMetadata ? partitionCount * RATING_INDEX_SIZE : 0);
+    if (size < required) {
+        printf("Invalid Sudoku file: %u puzzles do not fit in %zu bytes\n", count, size);
+        return std::nullopt;
+    }
+
+    pack.metadata = hasMetadata ? data + recordsOffset + recordsSize : nullptr;
+    const uchar* ratingIndices = hasMetadata ? pack.metadata + static_cast<size_t>(count) * METADATA_SIZE : nullptr;
+
+    for (size_t i = 0; i < partitionCount; ++i) {
+        const uchar* entry = toc + i * TOC_ENTRY_SIZE;
+        const size_t difficulty = entry[0];
+        const uint32_t first = readU32(entry + 4);
+        const uint32_t partitionSize = readU32(entry + 8);
+
+        if (difficulty >= MAX_PARTITIONS
+            || pack.partitions[difficulty].count != 0
+            || first > count
+            || partitionSize > count - first) {
+            printf("Invalid Sudoku file: bad partition %zu\n", i);
+            return std::nullopt;
+        }
+
+        const uchar* ratingIndex = hasMetadata ? ratingIndices + i * RATING_INDEX_SIZE : nullptr;
+
+        // compressed records by the checksums of their blocks
+        uint32_t crc;
+        if (compressed) {
+            const uint32_t firstBlock = first / perBlock;
+            const uint32_t endBlock = static_cast<uint32_t>((static_cast<uint64_t>(first) + partitionSize + perBlock - 1) / perBlock);
+            crc = crc32(pack.blocks.checksums + static_cast<size_t>(firstBlock) * 4, static_cast<size_t>(endBlock - firstBlock) * 4);
+        } else {
+            crc = crc32(pack.records + static_cast<size_t>(first) * ELEMENT_SIZE,
+                static_cast<size_t>(partitionSize) * ELEMENT_SIZE);
+        }
+        if (hasMetadata) {
+            crc = crc32(pack.metadata + static_cast<size_t>(first) * METADATA_SIZE,
+                static_cast<size_t>(partitionSize) * METADATA_SIZE, crc);
+            crc = crc32(ratingIndex, RATING_INDEX_SIZE, crc);
+        }
+        if (crc != readU32(entry + 12)) {
+            printf("Invalid Sudoku file: partition %zu checksum mismatch\n", i);
+            return std::nullopt;
+        }
+
+        if (hasMetadata && readU32(ratingIndex + 256 * 4) != partitionSize) {
+            printf("Invalid Sudoku file: bad rating index in partition %zu\n", i);
+            return std::nullopt;
+        }
+
+        pack.partitions[difficulty] = { first, partitionSize, crc, ratingIndex };
+    }
+
+    return pack;
+}
+
+// Validates the header and locates the records of the pack.
+static constexpr std::optional<Pack> validate(
+    const uchar* data,
+    const size_t size) {
     if (size < (sizeof(HEADER) + 4)) {
         printf("Invalid Sudoku file: %zu bytes\n", size);
         return std::nullopt;
     }
 
+    if (std::memcmp(data, HEADER_V1, sizeof(HEADER_V1)) == 0) {
+        return validateV1(data, size, false);
+    }
+    if (std::memcmp(data, HEADER_V2, sizeof(HEADER_V2)) == 0) {
+        return validateV1(data, size, true);
+    }
+
     if (std::memcmp(data, HEADER, sizeof(HEADER)) != 0) {
         printf("Invalid Sudoku file: bad header\n");
         return std::nullopt;
     }
 
-    uint32_t count =
-        static_cast<uint32_t>(data[8]) |
-        (static_cast<uint32_t>(data[9]) << 8) |
-        (static_cast<uint32_t>(data[10]) << 16) |
-        (static_cast<uint32_t>(data[11]) << 24);
+    uint32_t count = readU32(data + 8);
+
+    if ((size - sizeof(HEADER) - 4) / ELEMENT_SIZE < count) {
+        printf("Invalid Sudoku file: %u puzzles do not fit in %zu bytes\n", count, size);
+        return std::nullopt;
+    }
+
+    Pack pack = {};
+    pack.records = data + sizeof(HEADER) + 4;
+    pack.count = count;
+    return pack;
+}
 
+// `index`, or a random one, if it's one of `count`.
+static constexpr std::optional<size_t> pickIndex(
+    const uint32_t count,
+    std::optional<int> index) {
     const size_t puzzleIndex = index.has_value() ?
         static_cast<size_t>(index.value()) :
         static_cast<size_t>(QRandomGenerator::global()->bounded(count));
@@ -43,8 +233,19 @@ static constexpr std::optional<Sudoku> load(
         printf("Invalid Sudoku file: index %zu out of range (max %u)\n", puzzleIndex, count);
         return std::nullopt;
     }
+    return puzzleIndex;
+}
 
-    const uchar* puzzleData = data + sizeof(HEADER) + 4 + (puzzleIndex * ELEMENT_SIZE);
+static constexpr std::optional<Sudoku> decode(
+    const uchar* records,
+    const uint32_t count,
+    std::optional<int> index) {
+    const auto puzzleIndex = pickIndex(count, index);
+    if (!puzzleIndex.has_value()) {
+        return std::nullopt;
+    }
+
+    const uchar* puzzleData = records + (puzzleIndex.value() * ELEMENT_SIZE);
     const uchar* hintData = puzzleData + 41;
 
     Sudoku sudoku = {};
@@ -64,53 +265,451 @@ static constexpr std::optional<Sudoku> load(
     return sudoku;
 }
 
-std::optional<Sudoku> Sudoku::loadFromResource(
+// Hot blocks of all compressed packs.
+static BlockCache blockCache;
+
+// Record `index`, or a random one, of the `count` from `first` on, going
+// through the block cache for SUDOKU02.
+static constexpr std::optional<Sudoku> decodeAt(
+    const Pack& pack,
+    const uint32_t first,
+    const uint32_t count,
+    std::optional<int> index) {
+    if (pack.records != nullptr) {
+        return decode(pack.records + static_cast<size_t>(first) * ELEMENT_SIZE, count, index);
+    }
+
+    const auto puzzleIndex = pickIndex(count, index);
+    if (!puzzleIndex.has_value()) {
+        return std::nullopt;
+    }
+    uchar record[ELEMENT_SIZE] = {};
+    const uint32_t recordIndex = first + static_cast<uint32_t>(puzzleIndex.value());
+    if (!blockCache.read(pack.blocks, recordIndex, record)) {
+        printf("Invalid Sudoku file: record %u fails its block checksum or doesn't decode\n", recordIndex);
+        return std::nullopt;
+    }
+    return decode(record, 1, 0);
+}
+
+static constexpr std::optional<Partition> findPartition(const Pack& pack, Sudoku::Difficulty level) {
+    const size_t difficulty = static_cast<size_t>(level);
+    if (difficulty >= MAX_PARTITIONS || pack.partitions[difficulty].count == 0) {
+        printf("Sudoku pack has no puzzles for difficulty %zu\n", difficulty);
+        return std::nullopt;
+    }
+    return pack.partitions[difficulty];
+}
+
+static constexpr std::optional<Sudoku> decodePartition(
+    const Pack& pack,
     Sudoku::Difficulty level,
     std::optional<int> index) {
-    const char* resourcePath = nullptr;
+    auto partition = findPartition(pack, level);
+    if (!partition.has_value()) {
+        return std::nullopt;
+    }
+
+    return decodeAt(pack, partition->first, partition->count, index);
+}
+
+// Records are sorted by rating within a partition, so the rating index
+// turns a rating range into one contiguous slice.
+static constexpr std::optional<Sudoku> decodeRated(
+    const Pack& pack,
+    Sudoku::Difficulty level,
+    uint8_t minRating,
+    uint8_t maxRating) {
+    auto partition = findPartition(pack, level);
+    if (!partition.has_value() || partition->ratingIndex == nullptr || minRating > maxRating) {
+        return std::nullopt;
+    }
+
+    const uint32_t begin = readU32(partition->ratingIndex + minRating * 4);
+    const uint32_t end = readU32(partition->ratingIndex + (maxRating + 1) * 4);
+    if (begin >= end || end > partition->count) {
+        return std::nullopt;
+    }
+
+    return decodeAt(pack, partition->first + begin, end - begin, std::nullopt);
+}
+
+static constexpr std::optional<Sudoku> load(
+    const uchar* data,
+    const size_t size,
+    std::optional<int> index = std::nullopt) {
+    auto pack = validate(data, size);
+    if (!pack.has_value()) {
+        return std::nullopt;
+    }
+
+    return decodeAt(*pack, 0, pack->count, index);
+}
+
+static constexpr void decodeMask(const uchar* hintData, uint64_t* mask) {
+    uint64_t low = 0;
+    uint64_t high = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        low |= static_cast<uint64_t>(hintData[i]) << (i * 8);
+    }
+    for (size_t i = 8; i < HINT_SIZE; ++i) {
+        high |= static_cast<uint64_t>(hintData[i]) << ((i - 8) * 8);
+    }
+    mask[0] = low;
+    mask[1] = high & ((1ull << (CELL_COUNT - 64)) - 1);
+}
+
+static constexpr void decodeBatchScalar(
+    const uchar* records,
+    const size_t count,
+    uint8_t* digits,
+    uint64_t* masks) {
+    for (size_t n = 0; n < count; ++n) {
+        const uchar* puzzleData = records + n * ELEMENT_SIZE;
+        uint8_t* out = digits + n * CELL_COUNT;
+        for (size_t i = 0; i < PUZZLE_SIZE - 1; ++i) {
+            out[i * 2] = puzzleData[i] >> 4;
+            out[i * 2 + 1] = puzzleData[i] & 0x0F;
+        }
+        out[CELL_COUNT - 1] = puzzleData[PUZZLE_SIZE - 1] >> 4;
+
+        decodeMask(puzzleData + PUZZLE_SIZE, masks + n * 2);
+    }
+}
+
+#if defined(__ARM_NEON) || defined(__SSE2__)
+// 16 packed bytes into 32 digits, high nibble first
+static inline void unpackNibbles(const uchar* in, uint8_t* out) {
+#if defined(__ARM_NEON)
+    const uint8x16_t packed = vld1q_u8(in);
+    const uint8x16x2_t digits = vzipq_u8(vshrq_n_u8(packed, 4), vandq_u8(packed, vdupq_n_u8(0x0F)));
+    vst1q_u8(out, digits.val[0]);
+    vst1q_u8(out + 16, digits.val[1]);
+#else
+    const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i lowNibbles = _mm_set1_epi8(0x0F);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(packed, 4), lowNibbles);
+    const __m128i low = _mm_and_si128(packed, lowNibbles);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+#endif
+}
+
+static void decodeBatchVector(
+    const uchar* records,
+    const size_t count,
+    uint8_t* digits,
+    uint64_t* masks) {
+    // three 16 byte loads cover the 41 digit bytes and stay inside the
+    // 52 byte record, only the last 17 of 96 unpacked digits are kept
+    static_assert(3 * 16 <= ELEMENT_SIZE);
+
+    for (size_t n = 0; n < count; ++n) {
+        const uchar* puzzleData = records + n * ELEMENT_SIZE;
+        uint8_t* out = digits + n * CELL_COUNT;
+
+        unpackNibbles(puzzleData, out);
+        unpackNibbles(puzzleData + 16, out + 32);
+
+        uint8_t tail[32];
+        unpackNibbles(puzzleData + 32, tail);
+        std::memcpy(out + 64, tail, CELL_COUNT - 64);
+
+        decodeMask(puzzleData + PUZZLE_SIZE, masks + n * 2);
+    }
+}
+#endif
+
+// Packs stay open for the lifetime of the plugin so they are validated
+// once and repeated loads only touch the 52 bytes of the requested record.
+struct OpenPack {
+    // null for resources, which are always mapped
+    std::unique_ptr<QFile> file;
+    Pack pack;
+};
+
+static std::mutex openPacksLock;
+static std::unordered_map<std::string, OpenPack> openPacks;
+
+static const Pack* openPack(const char* path) {
+    std::lock_guard lock(openPacksLock);
+
+    auto it = openPacks.find(path);
+    if (it != openPacks.end()) {
+        return &it->second.pack;
+    }
+
+    std::unique_ptr<QFile> file;
+    const uchar* data = nullptr;
+    qint64 size = 0;
+
+    if (path[0] == ':') {
+        QResource res(path);
+        if (!res.isValid()) {
+            printf("Failed to load Sudoku resource: %s\n", path);
+            return nullptr;
+        }
+        data = res.data();
+        size = res.size();
+    } else {
+        file = std::make_unique<QFile>(path);
+        if (!file->open(QIODevice::ReadOnly)) {
+            return nullptr;
+        }
+
+        size = file->size();
+        data = size > 0 ? file->map(0, size) : nullptr;
+        if (data == nullptr) {
+            printf("Failed to map Sudoku file: %s\n", path);
+            return nullptr;
+        }
+    }
+
+    auto pack = validate(data, static_cast<size_t>(size));
+    if (!pack.has_value()) {
+        return nullptr;
+    }
 
-    switch (level) {
-    case Difficulty::Easy:
-        resourcePath = ":/bin/res/easy.bin";
-        break;
-    case Difficulty::Medium:
-        resourcePath = ":/bin/res/medium.bin";
-        break;
-    case Difficulty::Hard:
-        resourcePath = ":/bin/res/hard.bin";
-        break;
-    case Difficulty::Expert:
-        resourcePath = ":/bin/res/expert.bin";
-        break;
-    default:
-        printf("Invalid Sudoku difficulty level\n");
+    auto [inserted, _] = openPacks.emplace(path, OpenPack { std::move(file), pack.value() });
+    return &inserted->second.pack;
+}
+
+void Sudoku::encode(unsigned char* record) const {
+    std::fill(record, record + ELEMENT_SIZE, 0);
+    for (size_t i = 0; i < CELL_COUNT; ++i) {
+        record[i / 2] |= (i % 2) == 0 ? Number[i] << 4 : Number[i] & 0x0F;
+        record[PUZZLE_SIZE + i / 8] |= HintMask[i] << (i % 8);
+    }
+}
+
+// splitmix64, fixed here rather than left to the standard library so a
+// seed picks the same variant everywhere
+static uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template <size_t N>
+static void shuffle(std::array<uint8_t, N>& values, uint64_t& state) {
+    for (size_t i = N - 1; i > 0; --i) {
+        std::swap(values[i], values[nextRandom(state) % (i + 1)]);
+    }
+}
+
+// Which source line ends up at each of the nine rows or columns.
+static std::array<uint8_t, 9> shuffleLines(uint64_t& state) {
+    std::array<uint8_t, 3> bands = { 0, 1, 2 };
+    shuffle(bands, state);
+
+    std::array<uint8_t, 9> lines;
+    for (size_t band = 0; band < 3; ++band) {
+        std::array<uint8_t, 3> within = { 0, 1, 2 };
+        shuffle(within, state);
+        for (size_t i = 0; i < 3; ++i) {
+            lines[band * 3 + i] = bands[band] * 3 + within[i];
+        }
+    }
+    return lines;
+}
+
+Sudoku Sudoku::transformed(uint32_t seed) const {
+    uint64_t state = seed;
+    std::array<uint8_t, 9> digits = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    shuffle(digits, state);
+    const auto rows = shuffleLines(state);
+    const auto columns = shuffleLines(state);
+    const bool transpose = nextRandom(state) & 1;
+
+    Sudoku result = {};
+    for (size_t row = 0; row < 9; ++row) {
+        for (size_t column = 0; column < 9; ++column) {
+            const size_t source = transpose
+                ? columns[column] * 9 + rows[row]
+                : rows[row] * 9 + columns[column];
+            const char number = Number[source];
+            result.Number[row * 9 + column] = number >= 1 && number <= 9 ? digits[number - 1] : number;
+            result.HintMask[row * 9 + column] = HintMask[source];
+        }
+    }
+    return result;
+}
+
+static std::optional<Sudoku::Metadata> readMetadata(const Pack& pack, size_t index) {
+    if (pack.metadata == nullptr || index >= pack.count) {
+        return std::nullopt;
+    }
+
+    const uchar* data = pack.metadata + index * METADATA_SIZE;
+    return Sudoku::Metadata {
+        .rating = data[0],
+        .clues = data[1],
+        .seed = readU32(data + 4),
+    };
+}
+
+static std::mutex playedLock;
+static std::string playedDirectory;
+static std::array<PlayedSet, MAX_PARTITIONS> playedSets;
+
+void Sudoku::rememberPlayed(const char* directory) {
+    std::lock_guard lock(playedLock);
+    for (auto& played : playedSets) {
+        played.close();
+    }
+    playedDirectory = directory;
+}
+
+// An index into the partition that hasn't been played yet, std::nullopt
+// when nothing is remembered.
+static std::optional<int> pickUnplayed(Sudoku::Difficulty level, const Partition& partition) {
+    std::lock_guard lock(playedLock);
+    if (playedDirectory.empty()) {
+        return std::nullopt;
+    }
+
+    PlayedSet& played = playedSets[static_cast<size_t>(level)];
+    if (!played.isOpen()) {
+        const std::string path = playedDirectory + "/played-" + std::to_string(static_cast<int>(level)) + ".bin";
+        if (!played.open(path.c_str(), partition.count, partition.checksum)) {
+            // not worth failing again on every puzzle
+            playedDirectory.clear();
+            return std::nullopt;
+        }
+    }
+    return static_cast<int>(played.take(QRandomGenerator::global()->generate64()));
+}
+
+// An unplayed index into the difficulty's partition, or a random one when
+// nothing is remembered.
+static std::optional<int> pickFromPack(const Pack& pack, Sudoku::Difficulty level) {
+    const size_t difficulty = static_cast<size_t>(level);
+    if (difficulty >= MAX_PARTITIONS || pack.partitions[difficulty].count == 0) {
+        return std::nullopt;
+    }
+    const Partition& partition = pack.partitions[difficulty];
+    if (auto unplayed = pickUnplayed(level, partition)) {
+        return unplayed;
+    }
+    return static_cast<int>(QRandomGenerator::global()->bounded(partition.count));
+}
+
+std::optional<int> Sudoku::pickFromResource(Sudoku::Difficulty level) {
+    const Pack* pack = openPack(RESOURCE_PATH);
+    if (pack == nullptr) {
+        return std::nullopt;
+    }
+    return pickFromPack(*pack, level);
+}
+
+std::optional<Sudoku> Sudoku::loadFromResource(
+    Sudoku::Difficulty level,
+    std::optional<int> index,
+    std::optional<uint32_t> variant) {
+    printf("Loading Sudoku from resource: %s\n", RESOURCE_PATH);
+
+    const Pack* pack;
+    {
+        Tracer::Span span(Tracer::Phase::ResourceLookup);
+        pack = openPack(RESOURCE_PATH);
+    }
+    if (pack == nullptr) {
         return std::nullopt;
     }
-    printf("Loading Sudoku from resource: %s\n", resourcePath);
 
-    QResource res(resourcePath);
+    if (!index.has_value()) {
+        index = pickFromPack(*pack, level);
+    }
+
+    Tracer::Span span(Tracer::Phase::Decode);
+    auto sudoku = decodePartition(*pack, level, index);
+    if (sudoku.has_value() && variant.has_value()) {
+        return sudoku->transformed(variant.value());
+    }
+    return sudoku;
+}
+
+std::optional<Sudoku> Sudoku::loadRatedFromResource(
+    Sudoku::Difficulty level,
+    uint8_t minRating,
+    uint8_t maxRating) {
+    auto pack = openPack(RESOURCE_PATH);
+    if (pack == nullptr) {
+        return std::nullopt;
+    }
+
+    return decodeRated(*pack, level, minRating, maxRating);
+}
+
+std::optional<Sudoku::Metadata> Sudoku::metadataFromResource(
+    Sudoku::Difficulty level,
+    int index) {
+    auto pack = openPack(RESOURCE_PATH);
+    if (pack == nullptr) {
+        return std::nullopt;
+    }
 
-    if (!res.isValid()) {
-        printf("Failed to load Sudoku resource: %s\n", resourcePath);
+    auto partition = findPartition(*pack, level);
+    if (!partition.has_value() || index < 0 || static_cast<uint32_t>(index) >= partition->count) {
         return std::nullopt;
     }
 
-    return load(res.data(), res.size(), index);
+    return readMetadata(*pack, partition->first + static_cast<size_t>(index));
 }
 
 std::optional<Sudoku> Sudoku::loadFromFile(
     const char* path,
     std::optional<int> index) {
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
+    auto pack = openPack(path);
+    if (pack == nullptr) {
+        return std::nullopt;
+    }
+
+    return decodeAt(*pack, 0, pack->count, index);
+}
+
+std::optional<uint32_t> Sudoku::countInFile(const char* path) {
+    auto pack = openPack(path);
+    if (pack == nullptr) {
         return std::nullopt;
     }
 
-    QByteArray fileData = file.readAll();
-    return load(
-        reinterpret_cast<const uchar*>(fileData.constData()),
-        static_cast<size_t>(fileData.size()),
-        index);
+    return pack->count;
+}
+
+std::optional<Sudoku::Metadata> Sudoku::metadataFromFile(const char* path, int index) {
+    auto pack = openPack(path);
+    if (pack == nullptr || index < 0) {
+        return std::nullopt;
+    }
+
+    return readMetadata(*pack, static_cast<size_t>(index));
+}
+
+void Sudoku::decodeBatch(
+    const unsigned char* records,
+    size_t count,
+    uint8_t* digits,
+    uint64_t* masks) {
+#if defined(__ARM_NEON) || defined(__SSE2__)
+    decodeBatchVector(records, count, digits, masks);
+#else
+    decodeBatchScalar(records, count, digits, masks);
+#endif
+}
+
+std::span<const unsigned char> Sudoku::recordsInFile(const char* path) {
+    auto pack = openPack(path);
+    if (pack == nullptr) {
+        return {};
+    }
+
+    if (pack->records == nullptr) {
+        printf("Compressed Sudoku file has no raw records: %s\n", path);
+        return {};
+    }
+    return { pack->records, static_cast<size_t>(pack->count) * ELEMENT_SIZE };
 }
 
 constexpr const std::array<uchar, 116> compressedSudokuPuzzle = {
@@ -210,3 +809,80 @@ static_assert(
         1
     ).value() == decompressed1
 );
+
+constexpr const std::array<uchar, 156> compressedSudokuPack = {
+    // SUDOKU01
+    0x53, 0x55, 0x44, 0x4f, 0x4b, 0x55, 0x30, 0x31,
+    // count
+    0x02, 0x00, 0x00, 0x00,
+    // partition count, flags, reserved
+    0x02, 0x00, 0x00, 0x00,
+    // header + toc crc
+    0x13, 0xe3, 0x4b, 0x59,
+
+    // easy: puzzle 1
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x61, 0x52, 0x7d, 0xa5,
+    // expert: puzzle 0
+    0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x07, 0xa7, 0xe2, 0x64,
+
+    // puzzle 1, hints 1
+    0x57, 0x81, 0x29, 0x64, 0x39, 0x32, 0x65, 0x41,
+    0x87, 0x16, 0x48, 0x73, 0x95, 0x22, 0x87, 0x96,
+    0x15, 0x34, 0x69, 0x53, 0x47, 0x82, 0x13, 0x41,
+    0x28, 0x57, 0x96, 0x41, 0x37, 0x98, 0x26, 0x58,
+    0x56, 0x41, 0x23, 0x79, 0x72, 0x95, 0x36, 0x41,
+    0x80,
+    0x91, 0x84, 0x15, 0x19, 0x73, 0x00, 0xbc, 0x0b, 0x0c, 0x48, 0x00,
+
+    // puzzle 0, hints 0
+    0x17, 0x92, 0x38, 0x64,
+    0x56, 0x38, 0x45, 0x72, 0x19, 0x25, 0x49, 0x61,
+    0x87, 0x37, 0x46, 0x58, 0x39, 0x21, 0x31, 0x26,
+    0x49, 0x58, 0x79, 0x85, 0x17, 0x24, 0x36, 0x49,
+    0x38, 0x16, 0x75, 0x25, 0x67, 0x32, 0x41, 0x98,
+    0x82, 0x17, 0x95, 0x36, 0x40,
+    0x00, 0x51, 0x07, 0x88, 0x58, 0x03, 0x64, 0x29, 0x29, 0x61, 0x00,
+};
+
+static_assert(
+    decodePartition(
+        validate(compressedSudokuPack.data(), compressedSudokuPack.size()).value(),
+        Sudoku::Difficulty::Easy,
+        0
+    ).value() == decompressed1
+);
+
+static_assert(
+    decodePartition(
+        validate(compressedSudokuPack.data(), compressedSudokuPack.size()).value(),
+        Sudoku::Difficulty::Expert,
+        0
+    ).value() == decompressed0
+);
+
+static_assert(
+    load(
+        compressedSudokuPack.data(),
+        compressedSudokuPack.size(),
+        1
+    ).value() == decompressed0
+);
+
+constexpr bool decodesBatchTo(const uchar* records, size_t index, const Sudoku& expected) {
+    uint8_t digits[2 * CELL_COUNT] = {};
+    uint64_t masks[2 * 2] = {};
+    decodeBatchScalar(records, 2, digits, masks);
+
+    for (size_t i = 0; i < CELL_COUNT; ++i) {
+        const bool hint = (masks[index * 2 + i / 64] >> (i % 64)) & 1;
+        if (digits[index * CELL_COUNT + i] != expected.Number[i] || hint != expected.HintMask[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(decodesBatchTo(compressedSudokuPuzzle.data() + 12, 0, decompressed0));
+static_assert(decodesBatchTo(compressedSudokuPuzzle.data() + 12, 1, decompressed1));
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <span>
 
 class Sudoku {
 public:
@@ -11,12 +13,51 @@ public:
         Expert
     };
 
+    // Optional per-record information of SUDOKU01 packs.
+    struct Metadata {
+        uint8_t rating;
+        uint8_t clues;
+        uint32_t seed;
+    };
+
 public:
     char Number[81];
     bool HintMask[81];
 
-    static std::optional<Sudoku> loadFromResource(Sudoku::Difficulty level, std::optional<int> index);
+    // `index` is relative to the difficulty's partition of the bundled pack,
+    // without one an unplayed puzzle is picked once rememberPlayed is set.
+    // With a `variant`, the puzzle is transformed(variant) before it's returned.
+    static std::optional<Sudoku> loadFromResource(
+        Sudoku::Difficulty level, std::optional<int> index, std::optional<uint32_t> variant = std::nullopt);
+    // The index loadFromResource picks without one, so the puzzle it loads
+    // can be loaded again: an unplayed one once rememberPlayed is set,
+    // otherwise a random one. Picking marks it played.
+    static std::optional<int> pickFromResource(Sudoku::Difficulty level);
+    // Keeps a PlayedSet per difficulty of the bundled pack in `directory`.
+    static void rememberPlayed(const char* directory);
+    // Random puzzle with a rating in [minRating, maxRating].
+    static std::optional<Sudoku> loadRatedFromResource(Sudoku::Difficulty level, uint8_t minRating, uint8_t maxRating);
+    static std::optional<Metadata> metadataFromResource(Sudoku::Difficulty level, int index);
+    // Packs are memory mapped on first use and assumed not to change afterwards.
     static std::optional<Sudoku> loadFromFile(const char* path, std::optional<int> index);
+    static std::optional<uint32_t> countInFile(const char* path);
+    static std::optional<Metadata> metadataFromFile(const char* path, int index);
+
+    // Decodes `count` consecutive 52 byte records into a structure of
+    // arrays: 81 digits and two mask words (cells 0-63, 64-80) per puzzle.
+    static void decodeBatch(const unsigned char* records, size_t count, uint8_t* digits, uint64_t* masks);
+    // The raw records of a pack file, empty if it can't be opened or is
+    // compressed.
+    static std::span<const unsigned char> recordsInFile(const char* path);
+
+    // The 52 byte pack record of this puzzle, see res/README.md.
+    void encode(unsigned char* record) const;
+
+    // An equivalent puzzle picked by `seed`: digits relabelled, rows and
+    // columns shuffled within their bands and stacks, bands and stacks
+    // shuffled, and possibly transposed. It is exactly as hard as this one,
+    // and the same seed always picks the same variant.
+    Sudoku transformed(uint32_t seed) const;
 
     constexpr bool operator==(const Sudoku& other) const {
         for (size_t i = 0; i < 81; ++i) {
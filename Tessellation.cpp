@@ -0,0 +1,59 @@
+#include "Tessellation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// keeps tiny lassos round enough to select with
+constexpr const size_t MinCircleSegments = 8;
+constexpr const size_t MaxCircleSegments = 1024;
+
+static LinePoint penPoint(double x, double y) {
+    return (LinePoint){static_cast<float>(x), static_cast<float>(y), 25, 25, 0, 255};
+}
+
+size_t Tessellation::circleSegments(float radius, float tolerance) {
+    if (!(radius > tolerance)) {
+        return MinCircleSegments;
+    }
+    // a chord spanning `step` is radius * (1 - cos(step / 2)) off the arc
+    const double step = 2.0 * std::acos(1.0 - static_cast<double>(tolerance) / radius);
+    const double segments = std::ceil(2.0 * std::numbers::pi / step);
+    return std::clamp(static_cast<size_t>(segments), MinCircleSegments, MaxCircleSegments);
+}
+
+QList<LinePoint> Tessellation::circle(const QPointF& center, float radius, float tolerance) {
+    const size_t segments = circleSegments(radius, tolerance);
+    const double step = 2.0 * std::numbers::pi / static_cast<double>(segments);
+    const double cosStep = std::cos(step), sinStep = std::sin(step);
+
+    QList<LinePoint> points(segments + 1);
+    double x = radius, y = 0.0;
+    for (size_t i = 0; i < segments; ++i) {
+        points[i] = penPoint(center.x() + x, center.y() + y);
+        const double rotated = x * cosStep - y * sinStep;
+        y = x * sinStep + y * cosStep;
+        x = rotated;
+    }
+    points[segments] = points[0];
+    return points;
+}
+
+QList<LinePoint> Tessellation::star(const QPointF& center, double size, size_t points) {
+    // straight edges between the tips, nothing to subdivide
+    const size_t segments = points * 2;
+    const double step = std::numbers::pi / static_cast<double>(points);
+    const double cosStep = std::cos(step), sinStep = std::sin(step);
+
+    QList<LinePoint> outline(segments + 1);
+    double x = 1.0, y = 0.0;
+    for (size_t i = 0; i < segments; ++i) {
+        const double radius = (i % 2 == 0) ? size : (size / 2.0);
+        outline[i] = penPoint(center.x() + radius * x, center.y() + radius * y);
+        const double rotated = x * cosStep - y * sinStep;
+        y = x * sinStep + y * cosStep;
+        x = rotated;
+    }
+    outline[segments] = outline[0];
+    return outline;
+}
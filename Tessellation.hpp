@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+#include "rm_Line.hpp"
+
+// Outlines of round shapes with as few points as their size allows.
+// Consecutive points are found by rotating the previous one, so only the
+// step angle costs a cos/sin per shape.
+class Tessellation {
+public:
+    // How far a chord may stray from the arc it replaces, in pixels at the
+    // default zoom. Below what the pen rasterizes as a difference.
+    static constexpr const float ChordError = 0.25f;
+
+    // Segments a full circle of `radius` needs to stay within `tolerance`.
+    static size_t circleSegments(float radius, float tolerance = ChordError);
+
+    // Closed outline, the last point repeats the first.
+    static QList<LinePoint> circle(const QPointF& center, float radius, float tolerance = ChordError);
+    // Closed outline of a star whose inner points are at half `size`.
+    static QList<LinePoint> star(const QPointF& center, double size, size_t points);
+};
@@ -0,0 +1,129 @@
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+// four buckets per power of two, so percentiles are within ~20%
+constexpr const size_t SubBuckets = 4;
+constexpr const size_t BucketCount = 64 * SubBuckets;
+constexpr const size_t PhaseCount = static_cast<size_t>(Tracer::Phase::Count);
+
+constexpr const char* PhaseNames[PhaseCount] = {
+    "insert",
+    "lines",
+    "generate",
+    "resource lookup",
+    "decode",
+    "glyphs",
+    "addDrawingLine",
+    "renderLineToTiles",
+    "reload",
+    "recognize",
+    "stroke latency",
+};
+
+struct Histogram {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+    std::array<std::atomic<uint64_t>, BucketCount> buckets;
+};
+
+// on the threads waited on, then on background threads
+static std::array<std::array<Histogram, PhaseCount>, 2> histograms;
+
+std::atomic<bool> Tracer::isEnabled = false;
+thread_local bool Tracer::background = false;
+
+static constexpr size_t bucketOf(uint64_t nanoseconds) {
+    if (nanoseconds < SubBuckets) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    const size_t exponent = 63 - std::countl_zero(nanoseconds);
+    const size_t fraction = (nanoseconds >> (exponent - 2)) & (SubBuckets - 1);
+    return exponent * SubBuckets + fraction;
+}
+
+// inclusive upper end of a bucket
+static constexpr uint64_t bucketLimit(size_t bucket) {
+    if (bucket < SubBuckets) {
+        return bucket;
+    }
+    const size_t exponent = bucket / SubBuckets;
+    const uint64_t fraction = bucket % SubBuckets;
+    return ((SubBuckets + fraction + 1) << (exponent - 2)) - 1;
+}
+
+static_assert(bucketOf(0) == 0 && bucketOf(3) == 3);
+static_assert(bucketOf(4) == 8 && bucketLimit(8) == 4);
+static_assert(bucketOf(1000) == bucketOf(bucketLimit(bucketOf(1000))));
+static_assert(bucketOf(bucketLimit(bucketOf(1000)) + 1) == bucketOf(1000) + 1);
+
+void Tracer::record(Phase phase, uint64_t nanoseconds) {
+    auto& histogram = histograms[background][static_cast<size_t>(phase)];
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    histogram.buckets[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = histogram.max.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !histogram.max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void Tracer::reset() {
+    for (auto& set : histograms) {
+        for (auto& histogram : set) {
+            histogram.count = 0;
+            histogram.sum = 0;
+            histogram.max = 0;
+            for (auto& bucket : histogram.buckets) {
+                bucket = 0;
+            }
+        }
+    }
+}
+
+static uint64_t percentile(const Histogram& histogram, uint64_t count, double fraction) {
+    const uint64_t rank = static_cast<uint64_t>(fraction * (count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BucketCount; ++i) {
+        seen += histogram.buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return bucketLimit(i);
+        }
+    }
+    return histogram.max.load(std::memory_order_relaxed);
+}
+
+static void dumpSet(FILE* out, const std::array<Histogram, PhaseCount>& set, const char* title) {
+    fprintf(out, "%-18s %8s %10s %10s %10s %10s %10s\n",
+        title, "count", "mean", "p50", "p90", "p99", "max");
+
+    for (size_t phase = 0; phase < PhaseCount; ++phase) {
+        const auto& histogram = set[phase];
+        const uint64_t count = histogram.count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+
+        fprintf(out, "%-18s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+            PhaseNames[phase],
+            static_cast<unsigned long long>(count),
+            histogram.sum.load(std::memory_order_relaxed) / 1000.0 / count,
+            percentile(histogram, count, 0.5) / 1000.0,
+            percentile(histogram, count, 0.9) / 1000.0,
+            percentile(histogram, count, 0.99) / 1000.0,
+            histogram.max.load(std::memory_order_relaxed) / 1000.0);
+    }
+}
+
+void Tracer::dump(FILE* out) {
+    dumpSet(out, histograms[false], "phase (us)");
+
+    const auto& background = histograms[true];
+    if (std::any_of(background.begin(), background.end(),
+            [](const Histogram& histogram) { return histogram.count.load(std::memory_order_relaxed) != 0; })) {
+        dumpSet(out, background, "background (us)");
+    }
+}
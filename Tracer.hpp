@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Aggregates monotonic clock spans into per-phase latency histograms.
+// Everything is a relaxed atomic, so spans can be recorded from any
+// thread, and a disabled tracer costs one load per span.
+class Tracer {
+public:
+    enum class Phase {
+        Insert,
+        Lines,
+        Generate,
+        ResourceLookup,
+        Decode,
+        Glyphs,
+        AddDrawingLine,
+        RenderLineToTiles,
+        Reload,
+        Recognize,
+        StrokeLatency,
+        Count
+    };
+
+    static bool enabled() { return isEnabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled) { isEnabled.store(enabled, std::memory_order_relaxed); }
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Spans of the calling thread go to histograms of their own from now
+    // on, for work done ahead of time that nothing waits on.
+    static void markBackground() { background = true; }
+
+    static void record(Phase phase, uint64_t nanoseconds);
+    static void reset();
+    static void dump(FILE* out);
+
+    // Records the lifetime of the span if tracing was enabled when it started.
+    class Span {
+    public:
+        explicit Span(Phase phase) : phase(phase), start(enabled() ? now() : 0) {}
+        ~Span() {
+            if (start != 0) {
+                record(phase, now() - start);
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        Phase phase;
+        uint64_t start;
+    };
+
+private:
+    static std::atomic<bool> isEnabled;
+    static thread_local bool background;
+};
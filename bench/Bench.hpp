@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "Sudoku.hpp"
+
+struct BenchPack {
+    const char* name;
+    const char* file;
+};
+
+constexpr const BenchPack BundledPacks[] = {
+    { "easy",   "easy.bin" },
+    { "medium", "medium.bin" },
+    { "hard",   "hard.bin" },
+    { "expert", "expert.bin" },
+};
+
+class BenchTimer {
+public:
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Decodes every record of a pack in `directory`.
+std::vector<Sudoku> loadBenchPack(const char* directory, const BenchPack& pack);
+
+int benchSolver(int argc, char** argv);
+int benchGenerator(int argc, char** argv);
+int benchPacks(int argc, char** argv);
+int benchGlyphs(int argc, char** argv);
+int benchBatch(int argc, char** argv);
+int benchRecognizer(int argc, char** argv);
+int benchBoard(int argc, char** argv);
+int benchItems(int argc, char** argv);
+int benchShapes(int argc, char** argv);
+int benchVariants(int argc, char** argv);
+int benchRate(int argc, char** argv);
+int benchCanonical(int argc, char** argv);
+int benchPlayed(int argc, char** argv);
+int benchBlocks(int argc, char** argv);
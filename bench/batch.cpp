@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include "Bench.hpp"
+
+// usage: batch [resource directory] [puzzles per round]
+int benchBatch(int argc, char** argv) {
+    const std::string directory = argc > 0 ? argv[0] : "../res";
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<unsigned char> records;
+    for (const auto& pack : BundledPacks) {
+        const std::string path = directory + "/" + pack.file;
+        auto packRecords = Sudoku::recordsInFile(path.c_str());
+        if (packRecords.empty()) {
+            printf("Failed to load %s\n", path.c_str());
+            return 1;
+        }
+
+        // must match the single record decoder
+        const size_t packCount = packRecords.size() / 52;
+        std::vector<uint8_t> digits(packCount * 81);
+        std::vector<uint64_t> masks(packCount * 2);
+        Sudoku::decodeBatch(packRecords.data(), packCount, digits.data(), masks.data());
+        for (size_t i = 0; i < packCount; ++i) {
+            auto sudoku = Sudoku::loadFromFile(path.c_str(), static_cast<int>(i)).value();
+            for (size_t cell = 0; cell < 81; ++cell) {
+                const bool hint = (masks[i * 2 + cell / 64] >> (cell % 64)) & 1;
+                if (digits[i * 81 + cell] != sudoku.Number[cell] || hint != sudoku.HintMask[cell]) {
+                    printf("%s record %zu cell %zu decodes differently\n", pack.name, i, cell);
+                    return 1;
+                }
+            }
+        }
+
+        records.insert(records.end(), packRecords.begin(), packRecords.end());
+    }
+
+    const size_t bundled = records.size() / 52;
+    records.reserve(count * 52);
+    // repeats the bundled records, by index as inserting a range of the
+    // vector into itself isn't allowed
+    for (size_t i = records.size(); i < count * 52; ++i) {
+        records.push_back(records[i - bundled * 52]);
+    }
+
+    std::vector<uint8_t> digits(count * 81);
+    std::vector<uint64_t> masks(count * 2);
+
+    constexpr const int Rounds = 10;
+    BenchTimer batch;
+    for (int round = 0; round < Rounds; ++round) {
+        Sudoku::decodeBatch(records.data(), count, digits.data(), masks.data());
+    }
+    const double batchSeconds = batch.seconds();
+
+    const std::string single = directory + "/" + BundledPacks[0].file;
+    BenchTimer perRecord;
+    size_t checksum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        checksum += Sudoku::loadFromFile(single.c_str(), static_cast<int>(i % 1000))->Number[0];
+    }
+    const double perRecordSeconds = perRecord.seconds();
+
+    printf("verified %zu bundled records\n", bundled);
+    printf("loadFromFile: %12.0f puzzles/s (checksum %zu)\n", count / perRecordSeconds, checksum);
+    printf("decodeBatch:  %12.0f puzzles/s (checksum %u)\n",
+        count * Rounds / batchSeconds, digits[count * 81 - 1] + static_cast<unsigned>(masks[0] & 0xFF));
+    return 0;
+}
@@ -0,0 +1,22 @@
+# Host benchmarks for the plugin logic, e.g.
+#   qmake6 && make && ./sudoku-bench solver ../res
+TEMPLATE = app
+TARGET = sudoku-bench
+CONFIG += console c++20
+CONFIG -= app_bundle
+
+OBJECTS_DIR = build/obj
+MOC_DIR = build/moc
+
+QT = core
+
+SOURCES += \
+    main.cpp \
+    solver.cpp generator.cpp packs.cpp glyphs.cpp batch.cpp recognizer.cpp board.cpp items.cpp shapes.cpp variants.cpp rate.cpp canonical.cpp played.cpp blocks.cpp \
+    ../BlockPack.cpp ../BoardState.cpp ../Canonical.cpp ../PlayedSet.cpp ../Sudoku.cpp ../Solver.cpp ../Generator.cpp \
+    ../GlyphCache.cpp ../Rater.cpp ../Recognizer.cpp ../SceneItemPool.cpp ../Tessellation.cpp ../Tracer.cpp ../rm_Line.cpp ../rm_SceneLineItem.cpp
+
+HEADERS += Bench.hpp
+INCLUDEPATH += ..
+
+QMAKE_CXXFLAGS += -O2 -Werror -Wno-invalid-offsetof
@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "BlockPack.hpp"
+#include "Crc32.hpp"
+#include "Bench.hpp"
+
+static void putU32(std::vector<unsigned char>& out, size_t at, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[at + i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+}
+
+// usage: blocks [resource directory] [cached blocks]
+// Compresses the bundled records at several block sizes, reporting the
+// size against what a lookup costs when the block is cached and when not.
+int benchBlocks(int argc, char** argv) {
+    const std::string directory = argc > 0 ? argv[0] : "../res";
+    const size_t cached = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+
+    std::vector<unsigned char> records;
+    for (const auto& pack : BundledPacks) {
+        const auto raw = Sudoku::recordsInFile((directory + "/" + pack.file).c_str());
+        if (raw.empty()) {
+            printf("Failed to load %s\n", pack.file);
+            return 1;
+        }
+        records.insert(records.end(), raw.begin(), raw.end());
+    }
+    const uint32_t count = static_cast<uint32_t>(records.size() / 52);
+
+    printf("%u records, %zu bytes raw, %zu blocks cached\n", count, records.size(), cached);
+    printf("%8s %12s %10s %10s %12s %12s\n", "per block", "bytes", "per record", "miss", "random", "hit rate");
+
+    constexpr const uint32_t BlockSizes[] = { 1, 16, 64, 256, 1024 };
+    for (const uint32_t perBlock : BlockSizes) {
+        // offsets, checksums, then blocks, laid out as in a SUDOKU02 file
+        BlockPack pack = { nullptr, nullptr, nullptr, count, perBlock };
+        std::vector<unsigned char> offsets((pack.blockCount() + 1) * 4);
+        std::vector<unsigned char> checksums(pack.blockCount() * 4);
+        std::vector<unsigned char> blocks;
+        for (uint32_t block = 0; block < pack.blockCount(); ++block) {
+            const size_t begin = blocks.size();
+            putU32(offsets, block * 4, static_cast<uint32_t>(begin));
+            if (!BlockPack::compress(records.data() + static_cast<size_t>(block) * perBlock * 52, pack.blockSize(block), blocks)) {
+                printf("block %u doesn't compress\n", block);
+                return 1;
+            }
+            putU32(checksums, block * 4, crc32(blocks.data() + begin, blocks.size() - begin));
+        }
+        putU32(offsets, pack.blockCount() * 4, static_cast<uint32_t>(blocks.size()));
+        pack.offsets = offsets.data();
+        pack.checksums = checksums.data();
+        pack.blocks = blocks.data();
+
+        // every record reads back, and a lookup that always misses
+        BlockCache cold(1);
+        unsigned char record[52];
+        BenchTimer missTimer;
+        for (uint32_t i = 0; i < count; i += perBlock) {
+            if (!cold.read(pack, i, record) || std::memcmp(record, records.data() + static_cast<size_t>(i) * 52, 52) != 0) {
+                printf("record %u doesn't read back\n", i);
+                return 1;
+            }
+        }
+        const double miss = missTimer.seconds() / pack.blockCount();
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!cold.read(pack, i, record) || std::memcmp(record, records.data() + static_cast<size_t>(i) * 52, 52) != 0) {
+                printf("record %u doesn't read back\n", i);
+                return 1;
+            }
+        }
+
+        // uniformly random lookups, the worst case for the cache
+        constexpr const int Lookups = 20000;
+        BlockCache cache(cached);
+        std::mt19937 random(1);
+        size_t checksum = 0;
+        BenchTimer randomTimer;
+        for (int i = 0; i < Lookups; ++i) {
+            cache.read(pack, random() % count, record);
+            checksum += record[0];
+        }
+        const double lookup = randomTimer.seconds() / Lookups;
+
+        const size_t bytes = offsets.size() + checksums.size() + blocks.size();
+        printf("%8u %12zu %10.1f %8.1fus %10.1fus %11.1f%% (checksum %zu)\n",
+            perBlock, bytes, static_cast<double>(bytes) / count, miss * 1e6, lookup * 1e6,
+            100.0 * cache.hits() / (cache.hits() + cache.misses()), checksum);
+    }
+    return 0;
+}
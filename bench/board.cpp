@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "BoardState.hpp"
+#include "Bench.hpp"
+
+struct Edit {
+    uint8_t cell;
+    // 0 clears the cell
+    uint8_t digit;
+};
+
+// What the board state saves: scanning the cell's units for its digit.
+static bool scanConflict(const BoardState& board, int cell) {
+    const int digit = board.digit(cell);
+    if (digit == 0) {
+        return false;
+    }
+    const int row = cell / 9, column = cell % 9;
+    const int boxRow = row / 3 * 3, boxColumn = column / 3 * 3;
+    for (int i = 0; i < 9; ++i) {
+        const int inRow = row * 9 + i;
+        const int inColumn = i * 9 + column;
+        const int inBox = (boxRow + i / 3) * 9 + boxColumn + i % 3;
+        if ((inRow != cell && board.digit(inRow) == digit)
+            || (inColumn != cell && board.digit(inColumn) == digit)
+            || (inBox != cell && board.digit(inBox) == digit)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Someone filling in the puzzle: mostly the right digit, sometimes a
+// wrong one that gets erased again later, until finally solving it.
+static std::vector<Edit> recordEdits(const Sudoku& sudoku, size_t count, std::mt19937& random) {
+    std::vector<uint8_t> open;
+    for (uint8_t cell = 0; cell < 81; ++cell) {
+        if (!sudoku.HintMask[cell]) {
+            open.push_back(cell);
+        }
+    }
+
+    std::uniform_int_distribution<size_t> pick(0, open.size() - 1);
+    std::uniform_int_distribution<int> roll(0, 9);
+    std::vector<Edit> edits;
+    edits.reserve(count);
+    while (edits.size() < count) {
+        const uint8_t cell = open[pick(random)];
+        const int action = roll(random);
+        if (action < 6) {
+            edits.push_back({cell, static_cast<uint8_t>(sudoku.Number[cell])});
+        } else if (action < 9) {
+            edits.push_back({cell, static_cast<uint8_t>(roll(random) % 9 + 1)});
+        } else {
+            edits.push_back({cell, 0});
+        }
+    }
+    for (const auto cell : open) {
+        edits.push_back({cell, static_cast<uint8_t>(sudoku.Number[cell])});
+    }
+    return edits;
+}
+
+// usage: board <res directory> [edits per puzzle]
+int benchBoard(int argc, char** argv) {
+    if (argc < 1) {
+        printf("usage: board <res directory> [edits per puzzle]\n");
+        return 1;
+    }
+    const size_t editsPerPuzzle = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    std::mt19937 random(1);
+    for (const auto& pack : BundledPacks) {
+        auto puzzles = loadBenchPack(argv[0], pack);
+        if (puzzles.empty()) {
+            printf("%-8s no puzzles\n", pack.name);
+            continue;
+        }
+
+        std::vector<std::vector<Edit>> replays;
+        replays.reserve(puzzles.size());
+        for (const auto& sudoku : puzzles) {
+            replays.push_back(recordEdits(sudoku, editsPerPuzzle, random));
+        }
+
+        // the first puzzle doubles as a check against rescanning
+        BoardState board(puzzles[0]);
+        for (const auto& edit : replays[0]) {
+            edit.digit != 0 ? (void)board.place(edit.cell, edit.digit) : (void)board.clear(edit.cell);
+            for (int cell = 0; cell < 81; ++cell) {
+                if (board.hasConflict(cell) != scanConflict(board, cell)) {
+                    printf("%-8s conflict mismatch at cell %d\n", pack.name, cell);
+                    return 1;
+                }
+            }
+        }
+
+        size_t edits = 0, conflicts = 0, solved = 0;
+        BenchTimer timer;
+        for (size_t i = 0; i < puzzles.size(); ++i) {
+            board.reset(puzzles[i]);
+            for (const auto& edit : replays[i]) {
+                if (edit.digit == 0) {
+                    board.clear(edit.cell);
+                    continue;
+                }
+                if (board.place(edit.cell, edit.digit) == BoardState::Placement::Conflict) {
+                    ++conflicts;
+                }
+            }
+            edits += replays[i].size();
+            solved += board.solved();
+        }
+        const double seconds = timer.seconds();
+
+        printf("%-8s %8zu edits, %10.0f edits/s, %zu conflicts, %zu solved\n",
+            pack.name, edits, edits / seconds, conflicts, solved);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "Bench.hpp"
+#include "Canonical.hpp"
+
+// usage: canonical [resource directory] [variants per puzzle]
+int benchCanonical(int argc, char** argv) {
+    const std::string directory = argc > 0 ? argv[0] : "../res";
+    const uint32_t perPuzzle = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+
+    std::vector<Sudoku> puzzles;
+    std::vector<const char*> sources;
+    for (const auto& pack : BundledPacks) {
+        const auto packPuzzles = loadBenchPack(directory.c_str(), pack);
+        if (packPuzzles.empty()) {
+            printf("Failed to load %s\n", pack.file);
+            return 1;
+        }
+        puzzles.insert(puzzles.end(), packPuzzles.begin(), packPuzzles.end());
+        sources.insert(sources.end(), packPuzzles.size(), pack.name);
+    }
+
+    // every variant of a puzzle must land on the same form
+    std::vector<Sudoku> forms;
+    forms.reserve(puzzles.size());
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        const auto form = Canonical::form(puzzles[i]);
+        if (!(Canonical::form(form) == form)) {
+            printf("%s puzzle %zu: the form isn't its own form\n", sources[i], i);
+            return 1;
+        }
+        for (uint32_t seed = 0; seed < perPuzzle; ++seed) {
+            if (!(Canonical::form(puzzles[i].transformed(static_cast<uint32_t>(i) * perPuzzle + seed)) == form)) {
+                printf("%s puzzle %zu, seed %u: variant has another form\n", sources[i], i, seed);
+                return 1;
+            }
+        }
+        forms.push_back(form);
+    }
+
+    CanonicalIndex index(puzzles.size());
+    size_t duplicates = 0, collisions = 0;
+    for (size_t i = 0; i < forms.size(); ++i) {
+        const auto first = index.insert(Canonical::hash(forms[i]), static_cast<uint32_t>(i));
+        if (!first.has_value()) {
+            continue;
+        }
+        if (forms[first.value()] == forms[i]) {
+            // the first few tell enough
+            if (duplicates < 10) {
+                printf("%s puzzle %zu duplicates %s puzzle %u\n", sources[i], i, sources[first.value()], first.value());
+            }
+            ++duplicates;
+        } else {
+            ++collisions;
+        }
+    }
+
+    constexpr const int Rounds = 20;
+    BenchTimer timer;
+    size_t checksum = 0;
+    for (int round = 0; round < Rounds; ++round) {
+        for (const auto& sudoku : puzzles) {
+            checksum += Canonical::hash(Canonical::form(sudoku)) & 0xFF;
+        }
+    }
+    const double seconds = timer.seconds();
+
+    printf("%zu puzzles, %zu variants each agree, %zu duplicates, %zu hash collisions\n",
+        puzzles.size(), static_cast<size_t>(perPuzzle), duplicates, collisions);
+    printf("%.0f canonical forms/s on one thread (checksum %zu)\n",
+        Rounds * puzzles.size() / seconds, checksum);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "Bench.hpp"
+#include "Generator.hpp"
+#include "Rater.hpp"
+#include "Solver.hpp"
+
+// usage: generator [puzzles per difficulty] [budget in ms]
+int benchGenerator(int argc, char** argv) {
+    const int count = argc > 0 ? std::atoi(argv[0]) : 200;
+    const auto budget = std::chrono::milliseconds(argc > 1 ? std::atoi(argv[1]) : 100);
+
+    for (int level = 0; level < 4; ++level) {
+        const auto difficulty = static_cast<Sudoku::Difficulty>(level);
+
+        int missed = 0;
+        int invalid = 0;
+        int misrated = 0;
+        double worst = 0.0;
+        BenchTimer total;
+        for (int i = 0; i < count; ++i) {
+            BenchTimer timer;
+            auto sudoku = Generator::generate(difficulty, static_cast<uint32_t>(i) * 7919 + 1, budget);
+            worst = std::max(worst, timer.seconds());
+
+            if (!sudoku.has_value()) {
+                ++missed;
+            } else if (!Solver::hasUniqueSolution(Solver::givens(sudoku.value()))) {
+                ++invalid;
+            } else if (Rater::difficulty(Rater::rate(sudoku.value())) != difficulty) {
+                ++misrated;
+            }
+        }
+
+        printf("%-8s %2d clues: avg %7.3fms, worst %7.3fms, %d over budget, %d not unique, %d misrated\n",
+            BundledPacks[level].name, Generator::targetClues(difficulty),
+            total.seconds() * 1000.0 / count, worst * 1000.0, missed, invalid, misrated);
+    }
+
+    return 0;
+}
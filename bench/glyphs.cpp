@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "Bench.hpp"
+#include "GlyphCache.hpp"
+#include "res/digits.hpp"
+
+// What PuzzleManager::getNumber did before the glyph cache.
+static QList<LinePoint> scaleGlyph(int number, const QPointF& center, float scale) {
+    auto points = DigitPoints[number - 1];
+    auto pointCount = points.size();
+
+    QList<LinePoint> linePoints(pointCount);
+
+    for (size_t i = 0; i < pointCount; i++) {
+        linePoints[i] = (LinePoint){
+            static_cast<float>(center.x()) + points[i].x *  scale,
+            static_cast<float>(center.y()) + points[i].y * -scale,
+            25, 25, 0, 255};
+    }
+    return linePoints;
+}
+
+// usage: glyphs [glyph count]
+int benchGlyphs(int argc, char** argv) {
+    const int count = argc > 0 ? std::atoi(argv[0]) : 2000000;
+    constexpr const float Scale = 40.0f;
+
+    // same points either way
+    for (int number = 1; number <= 9; ++number) {
+        auto expected = scaleGlyph(number, QPointF(12.5, -7.25), Scale);
+        auto cached = GlyphCache::place(number, QPointF(12.5, -7.25), Scale);
+        if (expected.size() != cached.size()
+            || std::memcmp(expected.constData(), cached.constData(), expected.size() * sizeof(LinePoint)) != 0) {
+            printf("Glyph %d differs from the scaled digit\n", number);
+            return 1;
+        }
+    }
+
+    size_t checksum = 0;
+
+    BenchTimer scaled;
+    for (int i = 0; i < count; ++i) {
+        checksum += scaleGlyph(i % 9 + 1, QPointF(i % 1000, i % 777), Scale).size();
+    }
+    const double scaledSeconds = scaled.seconds();
+
+    BenchTimer cached;
+    for (int i = 0; i < count; ++i) {
+        checksum += GlyphCache::place(i % 9 + 1, QPointF(i % 1000, i % 777), Scale).size();
+    }
+    const double cachedSeconds = cached.seconds();
+
+    printf("scaled per call: %10.0f glyphs/s\n", count / scaledSeconds);
+    printf("glyph cache:     %10.0f glyphs/s (checksum %zu)\n", count / cachedSeconds, checksum);
+    return 0;
+}
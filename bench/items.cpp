@@ -0,0 +1,100 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "Bench.hpp"
+#include "SceneItemPool.hpp"
+#include "rm_SceneLineItem.hpp"
+
+// Every allocation of the bench binary goes through here, Qt's included:
+// QList storage comes from malloc rather than operator new. The count is
+// only read around the loops below.
+static std::atomic<size_t> allocations = 0;
+
+extern "C" {
+// glibc's own allocator, what these forward to
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+
+void* malloc(size_t size) {
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    ++allocations;
+    return __libc_realloc(pointer, size);
+}
+}
+
+// The points of PuzzleManager::createStar.
+static QList<LinePoint> starPoints(const QPointF& center, double size, size_t points) {
+    const size_t segments = points * 2;
+    QList<LinePoint> star(segments + 1);
+    for (size_t i = 0; i < segments + 1; i++) {
+        const double angle = (static_cast<double>(i) / static_cast<double>(segments)) * 2.0 * 3.14159265;
+        const double radius = (i % 2 == 0) ? size : (size / 2.0);
+        star[i] = (LinePoint){
+            static_cast<float>(center.x() + radius * std::cos(angle)),
+            static_cast<float>(center.y() + radius * std::sin(angle)),
+            25, 25, 0, 255};
+    }
+    return star;
+}
+
+struct ItemResult {
+    double seconds;
+    size_t allocations;
+};
+
+// Builds and releases `batches` clipboard batches of `count` stars.
+template <typename Batch>
+static ItemResult measure(size_t count, size_t batches, Batch batch) {
+    const size_t before = allocations;
+    BenchTimer timer;
+    for (size_t i = 0; i < batches; ++i) {
+        QList<std::shared_ptr<SceneItem>> items(count);
+        batch(items);
+    }
+    return { timer.seconds(), allocations - before };
+}
+
+// usage: items [items per batch] [batches]
+int benchItems(int argc, char** argv) {
+    const size_t count = argc > 0 ? std::strtoul(argv[0], nullptr, 10) : 20;
+    const size_t batches = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+    SceneLineItem::vtable_ptr = &allocations;
+
+    // what copyStars did before the pool: the points were copied once
+    // more by fromPoints and every item was allocated on its own
+    const auto copied = measure(count, batches, [count](QList<std::shared_ptr<SceneItem>>& items) {
+        for (size_t i = 0; i < count; ++i) {
+            const QPointF center(i * 10.0, i * 5.0);
+            const auto points = starPoints(center, 30.0, 5);
+            items[i] = std::make_shared<SceneLineItem>(SceneLineItem::fromLine(
+                Line::fromPoints(std::span<const LinePoint>(points), center, 30.0f)));
+        }
+    });
+
+    const auto pooled = measure(count, batches, [count](QList<std::shared_ptr<SceneItem>>& items) {
+        SceneItemPool pool(count);
+        for (size_t i = 0; i < count; ++i) {
+            const QPointF center(i * 10.0, i * 5.0);
+            items[i] = pool.make(Line::fromPoints(starPoints(center, 30.0, 5), center, 30.0f));
+        }
+    });
+
+    const double items = static_cast<double>(count * batches);
+    printf("copied, per item: %5.2f allocations %7.1f ns\n",
+        copied.allocations / items, copied.seconds * 1e9 / items);
+    printf("pooled, per item: %5.2f allocations %7.1f ns\n",
+        pooled.allocations / items, pooled.seconds * 1e9 / items);
+    return 0;
+}
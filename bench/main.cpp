@@ -0,0 +1,54 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "Bench.hpp"
+
+struct Benchmark {
+    const char* name;
+    int (*run)(int argc, char** argv);
+};
+
+constexpr const Benchmark Benchmarks[] = {
+    { "solver", benchSolver },
+    { "generator", benchGenerator },
+    { "packs", benchPacks },
+    { "glyphs", benchGlyphs },
+    { "batch", benchBatch },
+    { "recognizer", benchRecognizer },
+    { "board", benchBoard },
+    { "items", benchItems },
+    { "shapes", benchShapes },
+    { "variants", benchVariants },
+    { "rate", benchRate },
+    { "canonical", benchCanonical },
+    { "played", benchPlayed },
+    { "blocks", benchBlocks },
+};
+
+std::vector<Sudoku> loadBenchPack(const char* directory, const BenchPack& pack) {
+    std::string path = std::string(directory) + "/" + pack.file;
+
+    std::vector<Sudoku> puzzles;
+    const uint32_t count = Sudoku::countInFile(path.c_str()).value_or(0);
+    puzzles.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        puzzles.push_back(Sudoku::loadFromFile(path.c_str(), static_cast<int>(i)).value());
+    }
+    return puzzles;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2) {
+        for (const auto& benchmark : Benchmarks) {
+            if (std::strcmp(argv[1], benchmark.name) == 0) {
+                return benchmark.run(argc - 2, argv + 2);
+            }
+        }
+    }
+
+    printf("Usage: %s <benchmark> [args...]\n", argv[0]);
+    for (const auto& benchmark : Benchmarks) {
+        printf("  %s\n", benchmark.name);
+    }
+    return 1;
+}
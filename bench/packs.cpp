@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include "Bench.hpp"
+
+// Writes a pack of `count` records by repeating the records of `source`.
+static bool writeSyntheticPack(const std::string& source, const std::string& path, uint32_t count) {
+    std::ifstream in(source, std::ios::binary);
+    std::vector<char> records((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (records.size() <= 12) {
+        return false;
+    }
+    records.erase(records.begin(), records.begin() + 12);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const char header[12] = {
+        'S', 'U', 'D', 'O', 'K', 'U', '0', '0',
+        static_cast<char>(count), static_cast<char>(count >> 8),
+        static_cast<char>(count >> 16), static_cast<char>(count >> 24),
+    };
+    out.write(header, sizeof(header));
+
+    for (uint32_t written = 0; written < count;) {
+        const uint32_t chunk = std::min<uint32_t>(count - written, records.size() / 52);
+        out.write(records.data(), static_cast<std::streamsize>(chunk) * 52);
+        written += chunk;
+    }
+    return static_cast<bool>(out);
+}
+
+// usage: packs [resource directory] [scratch directory]
+int benchPacks(int argc, char** argv) {
+    const std::string directory = argc > 0 ? argv[0] : "../res";
+    const std::string scratch = argc > 1 ? argv[1] : "/tmp";
+
+    constexpr const uint32_t Sizes[] = { 1000, 100000, 10000000 };
+    constexpr const int Loads = 100000;
+
+    for (auto size : Sizes) {
+        const std::string path = scratch + "/sudoku-bench-" + std::to_string(size) + ".bin";
+        if (!writeSyntheticPack(directory + "/easy.bin", path, size)) {
+            printf("Failed to write %s\n", path.c_str());
+            return 1;
+        }
+
+        BenchTimer first;
+        auto sudoku = Sudoku::loadFromFile(path.c_str(), size - 1);
+        const double firstSeconds = first.seconds();
+        if (!sudoku.has_value()) {
+            printf("Failed to load %s\n", path.c_str());
+            return 1;
+        }
+
+        std::mt19937 random(size);
+        std::vector<int> indices(Loads);
+        for (auto& index : indices) {
+            index = static_cast<int>(random() % size);
+        }
+
+        BenchTimer subsequent;
+        size_t checksum = 0;
+        for (auto index : indices) {
+            checksum += Sudoku::loadFromFile(path.c_str(), index)->Number[80];
+        }
+        const double subsequentSeconds = subsequent.seconds();
+
+        printf("%9u puzzles: first load %9.1fus, subsequent %6.0fns/load (checksum %zu)\n",
+            size, firstSeconds * 1e6, subsequentSeconds * 1e9 / Loads, checksum);
+
+        std::remove(path.c_str());
+    }
+
+    return 0;
+}
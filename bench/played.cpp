@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "Bench.hpp"
+#include "PlayedSet.hpp"
+
+// usage: played [records] [file]
+int benchPlayed(int argc, char** argv) {
+    const uint32_t count = argc > 0 ? std::strtoul(argv[0], nullptr, 10) : 10000000;
+    const std::string path = argc > 1 ? argv[1] : "/tmp/sudoku-bench-played.bin";
+    std::remove(path.c_str());
+
+    PlayedSet played;
+    if (!played.open(path.c_str(), count, 0)) {
+        return 1;
+    }
+
+    // time per pick as the set fills up, the last stretch is the hard part
+    constexpr const double Marks[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+    std::mt19937_64 random(1);
+    std::vector<bool> seen(count);
+    uint32_t taken = 0;
+    for (const double mark : Marks) {
+        const uint32_t until = static_cast<uint32_t>(count * mark);
+        const uint32_t from = taken;
+        BenchTimer timer;
+        for (; taken < until; ++taken) {
+            const uint32_t index = played.take(random());
+            if (index >= count || seen[index]) {
+                printf("record %u picked twice\n", index);
+                return 1;
+            }
+            seen[index] = true;
+        }
+        const double seconds = timer.seconds();
+        printf("up to %6.2f%% played: %6.1f ns per pick\n",
+            mark * 100.0, seconds * 1e9 / std::max<uint32_t>(until - from, 1));
+    }
+
+    BenchTimer reopen;
+    played.close();
+    if (!played.open(path.c_str(), count, 0) || played.played() != count) {
+        printf("the played records didn't survive reopening\n");
+        return 1;
+    }
+    printf("%u records, reopened in %.2fms, next pick starts over at %u\n",
+        count, reopen.seconds() * 1e3, (played.take(random()), played.played()));
+    std::remove(path.c_str());
+    return 0;
+}
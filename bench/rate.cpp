@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "Bench.hpp"
+#include "Rater.hpp"
+
+
+constexpr const char* DifficultyNames[] = { "easy", "medium", "hard", "expert" };
+
+// usage: rate [resource directory] [puzzles to time] [threads] [ratings file]
+// The ratings file is what sudoku-compress.py pack --ratings takes.
+int benchRate(int argc, char** argv) {
+    const std::string directory = argc > 0 ? argv[0] : "../res";
+    const size_t timed = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    // 0 for one per core
+    const unsigned requested = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    const unsigned threads = requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+
+    FILE* ratings = nullptr;
+    if (argc > 3 && (ratings = fopen(argv[3], "w")) == nullptr) {
+        printf("Failed to open %s\n", argv[3]);
+        return 1;
+    }
+
+    std::vector<Solver::Board> corpus;
+    printf("labelled  rated easy medium   hard expert | hardest technique\n");
+    for (size_t label = 0; label < std::size(BundledPacks); ++label) {
+        const auto& pack = BundledPacks[label];
+        const auto puzzles = loadBenchPack(directory.c_str(), pack);
+        const auto records = Sudoku::recordsInFile((directory + "/" + pack.file).c_str());
+        if (puzzles.empty() || records.size() != puzzles.size() * 52) {
+            printf("Failed to load %s\n", pack.file);
+            return 1;
+        }
+
+        size_t rated[4] = {};
+        size_t techniques[Rater::TechniqueCount] = {};
+        for (size_t i = 0; i < puzzles.size(); ++i) {
+            Solver::Board filled;
+            const auto rating = Rater::rate(puzzles[i], &filled);
+
+            // deductions are never wrong, only sometimes not enough
+            for (size_t cell = 0; cell < 81; ++cell) {
+                if (filled[cell] != 0 ? filled[cell] != puzzles[i].Number[cell]
+                                      : rating.hardest != Rater::Technique::Unsolved) {
+                    printf("%s puzzle %zu: cell %zu deduced wrong\n", pack.name, i, cell);
+                    return 1;
+                }
+            }
+
+            const int difficulty = static_cast<int>(Rater::difficulty(rating));
+            if (ratings != nullptr) {
+                for (size_t byte = 0; byte < 52; ++byte) {
+                    fprintf(ratings, "%02x", records[i * 52 + byte]);
+                }
+                fprintf(ratings, " %u %s\n", rating.rating, DifficultyNames[difficulty]);
+            }
+            ++rated[difficulty];
+            ++techniques[static_cast<int>(rating.hardest)];
+            corpus.push_back(Solver::givens(puzzles[i]));
+        }
+
+        printf("%-8s %11zu %6zu %6zu %6zu |", pack.name, rated[0], rated[1], rated[2], rated[3]);
+        for (int technique = 0; technique < Rater::TechniqueCount; ++technique) {
+            if (techniques[technique] != 0) {
+                printf(" %s %zu,", Rater::name(static_cast<Rater::Technique>(technique)), techniques[technique]);
+            }
+        }
+        printf("\n");
+    }
+
+    if (ratings != nullptr) {
+        fclose(ratings);
+    }
+
+    // the bundled puzzles over and over, split across the threads
+    std::atomic<size_t> checksum = 0;
+    BenchTimer timer;
+    std::vector<std::thread> workers;
+    for (unsigned thread = 0; thread < threads; ++thread) {
+        workers.emplace_back([&, thread] {
+            size_t sum = 0;
+            for (size_t i = thread; i < timed; i += threads) {
+                sum += Rater::rate(corpus[i % corpus.size()]).rating;
+            }
+            checksum += sum;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double seconds = timer.seconds();
+
+    printf("%zu puzzles on %u threads: %.0f puzzles/s (checksum %zu)\n",
+        timed, threads, timed / seconds, checksum.load());
+    return 0;
+}
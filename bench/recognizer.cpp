@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include "Bench.hpp"
+#include "Recognizer.hpp"
+#include "res/digits.hpp"
+
+struct Sample {
+    int digit;
+    QList<QList<LinePoint>> strokes;
+};
+
+// Roughly what the pen reports: a point every few pixels, with jitter.
+static QList<LinePoint> trace(const std::vector<Coordinate>& path, std::mt19937& random) {
+    std::normal_distribution<float> jitter(0.0f, 0.8f);
+    QList<LinePoint> points;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const float length = std::hypot(path[i + 1].x - path[i].x, path[i + 1].y - path[i].y);
+        const int steps = std::max(1, static_cast<int>(length / 3.0f));
+        for (int step = 0; step < steps; ++step) {
+            const float t = static_cast<float>(step) / steps;
+            points.append((LinePoint){
+                path[i].x + t * (path[i + 1].x - path[i].x) + jitter(random),
+                path[i].y + t * (path[i + 1].y - path[i].y) + jitter(random),
+                25, 25, 0, 255});
+        }
+    }
+    points.append((LinePoint){path.back().x, path.back().y, 25, 25, 0, 255});
+    return points;
+}
+
+// A glyph as someone might write it: slanted, squashed, in a cell at
+// NumberScale, sometimes split into two strokes or written backwards.
+static Sample synthesize(int digit, std::mt19937& random) {
+    std::uniform_real_distribution<float> rotation(-0.17f, 0.17f);
+    std::uniform_real_distribution<float> shear(-0.2f, 0.2f);
+    std::uniform_real_distribution<float> stretch(0.8f, 1.2f);
+    std::uniform_real_distribution<float> offset(-15.0f, 15.0f);
+    std::uniform_int_distribution<int> coin(0, 1);
+
+    std::vector<Coordinate> path;
+    if (digit == 1 && coin(random)) {
+        path = { Coordinate(0.0f, -1.0f), Coordinate(0.0f, 1.0f) };
+    } else {
+        auto glyph = DigitPoints[digit - 1];
+        path.assign(glyph.begin(), glyph.end());
+    }
+
+    const float angle = rotation(random);
+    const float slant = shear(random);
+    const float width = stretch(random);
+    const float cx = offset(random), cy = offset(random);
+    constexpr const float Scale = 40.0f;
+    for (auto& point : path) {
+        const float x = (point.x + slant * point.y) * width;
+        const float y = -point.y;
+        point = Coordinate(
+            cx + Scale * (x * std::cos(angle) - y * std::sin(angle)),
+            cy + Scale * (x * std::sin(angle) + y * std::cos(angle)));
+    }
+
+    Sample sample{digit, {}};
+    if (path.size() > 4 && coin(random)) {
+        const size_t split = std::uniform_int_distribution<size_t>(1, path.size() - 2)(random);
+        sample.strokes.append(trace({path.begin(), path.begin() + split + 1}, random));
+        sample.strokes.append(trace({path.begin() + split, path.end()}, random));
+    } else {
+        sample.strokes.append(trace(path, random));
+    }
+    for (auto& stroke : sample.strokes) {
+        if (coin(random)) {
+            std::reverse(stroke.begin(), stroke.end());
+        }
+    }
+    return sample;
+}
+
+// One sample per line: the digit, then strokes of x,y pairs separated by |
+//   4 10,5 2,30 20,30 | 15,0 15,40
+static std::vector<Sample> loadCorpus(const char* path) {
+    std::vector<Sample> samples;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream words(line);
+        Sample sample{0, {}};
+        if (!(words >> sample.digit)) {
+            continue;
+        }
+        sample.strokes.append(QList<LinePoint>());
+        std::string word;
+        while (words >> word) {
+            float x, y;
+            if (word == "|") {
+                sample.strokes.append(QList<LinePoint>());
+            } else if (std::sscanf(word.c_str(), "%f,%f", &x, &y) == 2) {
+                sample.strokes.back().append((LinePoint){x, y, 25, 25, 0, 255});
+            }
+        }
+        samples.push_back(std::move(sample));
+    }
+    return samples;
+}
+
+// usage: recognizer [samples per digit | corpus file]
+int benchRecognizer(int argc, char** argv) {
+    std::vector<Sample> samples;
+    const int perDigit = argc > 0 ? std::atoi(argv[0]) : 2000;
+    if (argc > 0 && perDigit == 0) {
+        samples = loadCorpus(argv[0]);
+        if (samples.empty()) {
+            printf("No samples in %s\n", argv[0]);
+            return 1;
+        }
+    } else {
+        std::mt19937 random(1);
+        for (int i = 0; i < perDigit; ++i) {
+            for (int digit = 1; digit <= 9; ++digit) {
+                samples.push_back(synthesize(digit, random));
+            }
+        }
+    }
+
+    int confusion[10][10] = {};
+    std::vector<double> latencies;
+    std::vector<float> distances;
+    latencies.reserve(samples.size());
+
+    BenchTimer total;
+    for (const auto& sample : samples) {
+        BenchTimer timer;
+        auto match = Recognizer::recognize(sample.strokes);
+        latencies.push_back(timer.seconds());
+        confusion[sample.digit][match.has_value() ? match->digit : 0]++;
+        if (match.has_value() && match->digit == sample.digit) {
+            distances.push_back(match->distance);
+        }
+    }
+    const double seconds = total.seconds();
+
+    int correct = 0, rejected = 0;
+    for (int digit = 1; digit <= 9; ++digit) {
+        correct += confusion[digit][digit];
+        rejected += confusion[digit][0];
+        printf("%d:", digit);
+        for (int guess = 0; guess <= 9; ++guess) {
+            printf(" %6d", confusion[digit][guess]);
+        }
+        printf("\n");
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(distances.begin(), distances.end());
+    printf("%zu samples, %.1f%% correct, %.1f%% rejected\n", samples.size(),
+        100.0 * correct / samples.size(), 100.0 * rejected / samples.size());
+    printf("per sample: mean %.1fus, p99 %.1fus, max %.1fus\n",
+        seconds / samples.size() * 1e6,
+        latencies[latencies.size() * 99 / 100] * 1e6,
+        latencies.back() * 1e6);
+    if (!distances.empty()) {
+        printf("distance when correct: p50 %.3f, p99 %.3f, max %.3f\n",
+            distances[distances.size() / 2],
+            distances[distances.size() * 99 / 100],
+            distances.back());
+    }
+    return 0;
+}
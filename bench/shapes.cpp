@@ -0,0 +1,94 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "Bench.hpp"
+#include "Tessellation.hpp"
+
+// What PuzzleManager::createCircle did before: 100 points at any size.
+static QList<LinePoint> fixedCircle(const QPointF& center, float radius) {
+    QList<LinePoint> points(100);
+    for (qsizetype i = 0; i < points.size(); i++) {
+        const float angle = (static_cast<float>(i) / static_cast<float>(points.size() - 1)) * 2.0f * 3.14159265f;
+        points[i] = (LinePoint){
+            static_cast<float>(center.x()) + radius * std::cos(angle),
+            static_cast<float>(center.y()) + radius * std::sin(angle),
+            25, 25, 0, 255};
+    }
+    return points;
+}
+
+// And createStar, with a cos/sin per point.
+static QList<LinePoint> trigStar(const QPointF& center, double size, size_t points) {
+    const size_t segments = points * 2;
+    QList<LinePoint> star(segments + 1);
+    for (size_t i = 0; i < segments + 1; i++) {
+        const double angle = (static_cast<double>(i) / static_cast<double>(segments)) * 2.0 * 3.14159265;
+        const double radius = (i % 2 == 0) ? size : (size / 2.0);
+        star[i] = (LinePoint){
+            static_cast<float>(center.x() + radius * std::cos(angle)),
+            static_cast<float>(center.y() + radius * std::sin(angle)),
+            25, 25, 0, 255};
+    }
+    return star;
+}
+
+// Furthest any chord midpoint or point is from the true circle.
+static double chordError(const QList<LinePoint>& points, const QPointF& center, float radius) {
+    double worst = 0.0;
+    for (qsizetype i = 0; i + 1 < points.size(); ++i) {
+        const double x = (points[i].x + points[i + 1].x) / 2.0 - center.x();
+        const double y = (points[i].y + points[i + 1].y) / 2.0 - center.y();
+        const double px = points[i].x - center.x(), py = points[i].y - center.y();
+        worst = std::max(worst, radius - std::hypot(x, y));
+        worst = std::max(worst, std::abs(radius - std::hypot(px, py)));
+    }
+    return worst;
+}
+
+template <typename Generate>
+static double nanosPerShape(int count, size_t& checksum, Generate generate) {
+    BenchTimer timer;
+    for (int i = 0; i < count; ++i) {
+        checksum += generate(QPointF(i % 1000, i % 777)).size();
+    }
+    return timer.seconds() * 1e9 / count;
+}
+
+// usage: shapes [shapes per size]
+int benchShapes(int argc, char** argv) {
+    const int count = argc > 0 ? std::atoi(argv[0]) : 200000;
+    constexpr const float Radii[] = { 5.0f, 10.0f, 25.0f, 50.0f, 100.0f, 200.0f, 400.0f, 800.0f };
+
+    size_t checksum = 0;
+    printf("radius  fixed points  error    ns | adaptive points  error    ns\n");
+    for (const float radius : Radii) {
+        const QPointF center(12.5, -7.25);
+        const auto fixed = fixedCircle(center, radius);
+        const auto adaptive = Tessellation::circle(center, radius);
+        const double adaptiveError = chordError(adaptive, center, radius);
+        if (adaptiveError > Tessellation::ChordError + 1e-3) {
+            printf("Circle of radius %.0f is off by %.3f\n", radius, adaptiveError);
+            return 1;
+        }
+
+        const double fixedNanos = nanosPerShape(count, checksum, [radius](const QPointF& at) {
+            return fixedCircle(at, radius);
+        });
+        const double adaptiveNanos = nanosPerShape(count, checksum, [radius](const QPointF& at) {
+            return Tessellation::circle(at, radius);
+        });
+        printf("%6.0f  %12lld %6.3f %5.0f | %15lld %6.3f %5.0f\n", radius,
+            static_cast<long long>(fixed.size()), chordError(fixed, center, radius), fixedNanos,
+            static_cast<long long>(adaptive.size()), adaptiveError, adaptiveNanos);
+    }
+
+    const double trigNanos = nanosPerShape(count, checksum, [](const QPointF& at) {
+        return trigStar(at, 30.0, 5);
+    });
+    const double rotatedNanos = nanosPerShape(count, checksum, [](const QPointF& at) {
+        return Tessellation::star(at, 30.0, 5);
+    });
+    printf("star: %.0f ns with cos/sin per point, %.0f ns rotated (checksum %zu)\n",
+        trigNanos, rotatedNanos, checksum);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <cstring>
+#include "Bench.hpp"
+#include "Solver.hpp"
+
+// usage: solver [resource directory]
+int benchSolver(int argc, char** argv) {
+    const char* directory = argc > 0 ? argv[0] : "../res";
+
+    for (const auto& pack : BundledPacks) {
+        auto puzzles = loadBenchPack(directory, pack);
+        if (puzzles.empty()) {
+            printf("%-8s failed to load\n", pack.name);
+            return 1;
+        }
+
+        std::vector<Solver::Board> givens;
+        givens.reserve(puzzles.size());
+        for (const auto& sudoku : puzzles) {
+            givens.push_back(Solver::givens(sudoku));
+        }
+
+        // check against the stored solutions before timing anything
+        size_t mismatches = 0;
+        size_t ambiguous = 0;
+        for (size_t i = 0; i < puzzles.size(); ++i) {
+            auto solution = Solver::solve(givens[i]);
+            if (!solution || std::memcmp(solution->data(), puzzles[i].Number, 81) != 0) {
+                ++mismatches;
+            }
+            if (!Solver::hasUniqueSolution(givens[i])) {
+                ++ambiguous;
+            }
+        }
+
+        constexpr const int Rounds = 20;
+
+        BenchTimer solveTimer;
+        size_t solved = 0;
+        for (int round = 0; round < Rounds; ++round) {
+            for (const auto& cells : givens) {
+                solved += Solver::solve(cells).has_value();
+            }
+        }
+        double solveSeconds = solveTimer.seconds();
+
+        BenchTimer uniqueTimer;
+        size_t unique = 0;
+        for (int round = 0; round < Rounds; ++round) {
+            for (const auto& cells : givens) {
+                unique += Solver::hasUniqueSolution(cells);
+            }
+        }
+        double uniqueSeconds = uniqueTimer.seconds();
+
+        printf("%-8s %5zu puzzles: %10.0f solves/s, %10.0f uniqueness checks/s "
+               "(%zu mismatches, %zu not unique)\n",
+            pack.name, puzzles.size(),
+            solved / solveSeconds, unique / uniqueSeconds,
+            mismatches, ambiguous);
+    }
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <set>
+#include <string>
+#include "Bench.hpp"
+#include "Solver.hpp"
+
+// Every row, column and box of the solution holds each digit once.
+static bool isSolutionGrid(const Sudoku& sudoku) {
+    for (int unit = 0; unit < 9; ++unit) {
+        int rows = 0, columns = 0, boxes = 0;
+        for (int i = 0; i < 9; ++i) {
+            const int box = (unit / 3 * 3 + i / 3) * 9 + unit % 3 * 3 + i % 3;
+            rows |= 1 << sudoku.Number[unit * 9 + i];
+            columns |= 1 << sudoku.Number[i * 9 + unit];
+            boxes |= 1 << sudoku.Number[box];
+        }
+        if (rows != 0x3FE || columns != 0x3FE || boxes != 0x3FE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int clueCount(const Sudoku& sudoku) {
+    int clues = 0;
+    for (bool hint : sudoku.HintMask) {
+        clues += hint;
+    }
+    return clues;
+}
+
+// usage: variants [resource directory] [variants per puzzle]
+int benchVariants(int argc, char** argv) {
+    const std::string directory = argc > 0 ? argv[0] : "../res";
+    const uint32_t perPuzzle = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+
+    for (const auto& pack : BundledPacks) {
+        const auto puzzles = loadBenchPack(directory.c_str(), pack);
+        if (puzzles.empty()) {
+            printf("Failed to load %s\n", pack.file);
+            return 1;
+        }
+
+        // a variant must still be a puzzle with the same single solution
+        std::set<std::string> distinct;
+        for (size_t i = 0; i < puzzles.size(); ++i) {
+            for (uint32_t seed = 0; seed < perPuzzle; ++seed) {
+                const auto variant = puzzles[i].transformed(static_cast<uint32_t>(i) * perPuzzle + seed);
+                if (!(variant == puzzles[i].transformed(static_cast<uint32_t>(i) * perPuzzle + seed))
+                    || !isSolutionGrid(variant) || clueCount(variant) != clueCount(puzzles[i])) {
+                    printf("%s puzzle %zu, seed %u: variant isn't equivalent\n", pack.name, i, seed);
+                    return 1;
+                }
+
+                const auto solution = Solver::solve(Solver::givens(variant));
+                if (!Solver::hasUniqueSolution(Solver::givens(variant))
+                    || !solution.has_value()
+                    || !std::equal(solution->begin(), solution->end(), variant.Number)) {
+                    printf("%s puzzle %zu, seed %u: variant solves differently\n", pack.name, i, seed);
+                    return 1;
+                }
+                distinct.emplace(variant.Number, variant.Number + 81);
+            }
+        }
+
+        constexpr const int Rounds = 200;
+        BenchTimer timer;
+        size_t checksum = 0;
+        for (int round = 0; round < Rounds; ++round) {
+            for (size_t i = 0; i < puzzles.size(); ++i) {
+                checksum += puzzles[i].transformed(static_cast<uint32_t>(round * puzzles.size() + i)).Number[40];
+            }
+        }
+        const double nanos = timer.seconds() * 1e9 / (Rounds * puzzles.size());
+
+        printf("%-6s %zu puzzles, %zu distinct of %zu variants, %4.0f ns/transform (checksum %zu)\n",
+            pack.name, puzzles.size(), distinct.size(), puzzles.size() * perPuzzle, nanos, checksum);
+    }
+    return 0;
+}
@@ -1,11 +1,21 @@
 #define _GNU_SOURCE
 #include <stdio.h>
 
+#include "vtable.h"
 #include "xovi.h"
 
 void registerQmldiff();
+void setupSceneLineItemVtable(void* vtable);
+
+static void resolveSceneLineItemVtable() {
+    void* vtable = findVtable("13SceneLineItem");
+    if (vtable != NULL) {
+        setupSceneLineItemVtable(vtable);
+    }
+}
 
 void _xovi_construct() {
+    resolveSceneLineItemVtable();
     printf("Registering PuzzleManager\n");
     Environment->requireExtension("qt-resource-rebuilder", 0, 2, 0);
     registerQmldiff();
@@ -0,0 +1,30 @@
+# Host (x86_64) build of the plugin logic against the recording scene
+# stand-ins in host/, build it out of tree so it doesn't clash with
+# sudoku.pro, e.g.
+#   mkdir build-host && cd build-host && qmake6 ../host.pro && make
+#   ./sudoku-host check
+TEMPLATE = app
+TARGET = sudoku-host
+CONFIG += console c++20
+CONFIG -= app_bundle
+
+OBJECTS_DIR = build/obj
+MOC_DIR = build/moc
+RCC_DIR = build/rcc
+
+QT = core
+
+SOURCES += \
+    host/main.cpp host/Flows.cpp host/SceneMock.cpp \
+    BlockPack.cpp PlayedSet.cpp PuzzleManager.cpp PuzzleQueue.cpp Sudoku.cpp Solver.cpp Generator.cpp Rater.cpp \
+    BoardState.cpp GlyphCache.cpp Recognizer.cpp SceneItemPool.cpp StrokePipeline.cpp StrokeRecorder.cpp Tessellation.cpp Tracer.cpp rm_Line.cpp rm_SceneLineItem.cpp vtable.c
+
+HEADERS += host/Flows.hpp host/SceneMock.hpp \
+    BlockPack.hpp BoardState.hpp Crc32.hpp GlyphCache.hpp PlayedSet.hpp PuzzleManager.hpp PuzzleQueue.hpp Recognizer.hpp SceneItemPool.hpp StrokePipeline.hpp StrokeRecorder.hpp Sudoku.hpp Solver.hpp Generator.hpp Rater.hpp Tessellation.hpp Tracer.hpp vtable.h
+INCLUDEPATH += . host
+
+QMAKE_CXXFLAGS += -Werror -Wno-invalid-offsetof
+
+LIBS += -ldl
+
+RESOURCES += sudoku.qrc
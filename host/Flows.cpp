@@ -0,0 +1,89 @@
+#include "Flows.hpp"
+
+bool Flows::hasSceneLineItemVtable = false;
+
+void Flows::drawPuzzle(PuzzleManager& manager, MockScene& scene, int difficulty) {
+    auto& sceneController = scene.sceneController;
+    auto& tileManager = scene.tileManager;
+
+    const bool trace = manager.tracing();
+    const double insertStart = trace ? manager.traceBegin() : 0;
+
+    // hints followed by the surrounding grid
+    const QVariantList lines = manager.getSudokuLines(difficulty);
+    if (lines.size() == 0) {
+        return;
+    }
+
+    sceneController.setLayerName(sceneController.currentLayer, "Sudoku");
+
+    for (qsizetype idx = 0; idx < lines.size(); ++idx) {
+        const Line line = lines[idx].value<Line>();
+        if (trace) {
+            const double start = manager.traceBegin();
+            sceneController.addDrawingLine(line);
+            manager.traceEnd(PuzzleManager::TraceAddDrawingLine, start);
+            continue;
+        }
+
+        sceneController.addDrawingLine(line);
+    }
+
+    if (!manager.renderSudokuToTiles(&tileManager)) {
+        for (qsizetype idx = 0; idx < lines.size(); ++idx) {
+            const double start = trace ? manager.traceBegin() : 0;
+            tileManager.renderLineToTiles(lines[idx].value<Line>());
+            if (trace) {
+                manager.traceEnd(PuzzleManager::TraceRenderLineToTiles, start);
+            }
+        }
+
+        const double reloadStart = trace ? manager.traceBegin() : 0;
+        tileManager.reload();
+        if (trace) {
+            manager.traceEnd(PuzzleManager::TraceReload, reloadStart);
+        }
+    }
+
+    sceneController.addLayer();
+
+    if (trace) {
+        manager.traceEnd(PuzzleManager::TraceInsert, insertStart);
+    }
+}
+
+void Flows::ensureVtablePtr(PuzzleManager& manager, MockScene& scene) {
+    // the qmd binds the property to this when the toolbar is created
+    hasSceneLineItemVtable = hasSceneLineItemVtable || manager.hasVtablePtr();
+    if (hasSceneLineItemVtable) {
+        return;
+    }
+
+    auto& sceneController = scene.sceneController;
+
+    // the qmd sleeps between these steps, the mock has no need to
+    sceneController.clearSelectedItems();
+    sceneController.addDrawingLine(
+        manager.createLine(QPointF(-5, -10), QPointF(5, -10)));
+    sceneController.selectWithLine(
+        manager.createCircle(QPointF(0, -10), 10));
+    hasSceneLineItemVtable = manager.setupVtablePtr(
+        sceneController.cloneSelectedItems(sceneController.currentLayer, 1.0));
+    sceneController.deleteSelectedItems(sceneController.currentLayer);
+    sceneController.clearSelectedItems();
+}
+
+void Flows::copyCrosshair(PuzzleManager& manager, MockScene& scene) {
+    ensureVtablePtr(manager, scene);
+    scene.clipboard.setItems(manager.copyCrosshair());
+}
+
+void Flows::copyStars(PuzzleManager& manager, MockScene& scene) {
+    ensureVtablePtr(manager, scene);
+    scene.clipboard.setItems(manager.copyStars(20, 800.0));
+}
+
+void Flows::copyPuzzle(PuzzleManager& manager, MockScene& scene, int difficulty) {
+    ensureVtablePtr(manager, scene);
+    scene.clipboard.setItems(manager.copySudoku(difficulty));
+}
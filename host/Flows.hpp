@@ -0,0 +1,18 @@
+#pragma once
+
+#include "PuzzleManager.hpp"
+#include "SceneMock.hpp"
+
+// The QML functions of sudoku.qmd, translated call for call so they can
+// run against MockScene. Keep these in sync with the qmd.
+class Flows {
+public:
+    static void drawPuzzle(PuzzleManager& manager, MockScene& scene, int difficulty);
+    static void ensureVtablePtr(PuzzleManager& manager, MockScene& scene);
+    static void copyCrosshair(PuzzleManager& manager, MockScene& scene);
+    static void copyStars(PuzzleManager& manager, MockScene& scene);
+    static void copyPuzzle(PuzzleManager& manager, MockScene& scene, int difficulty);
+
+    // hasSceneLineItemVtable of the toolbar item
+    static bool hasSceneLineItemVtable;
+};
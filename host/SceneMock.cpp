@@ -0,0 +1,85 @@
+#include "SceneMock.hpp"
+
+#include <algorithm>
+#include "rm_SceneLineItem.hpp"
+
+static int mockVtable[8];
+void* const SceneController::vtable = mockVtable;
+
+size_t SceneRecorder::count(SceneCall::Kind kind) const {
+    return std::count_if(calls.begin(), calls.end(),
+        [kind](const SceneCall& call) { return call.kind == kind; });
+}
+
+void SceneController::setLayerName(int layer, const QString& name) {
+    Q_UNUSED(name);
+    recorder.calls.push_back({ SceneCall::Kind::SetLayerName, layer, {}, 0, {} });
+}
+
+void SceneController::addDrawingLine(const Line& line) {
+    layers[currentLayer].push_back(line);
+    recorder.calls.push_back({ SceneCall::Kind::AddDrawingLine, currentLayer, line, 1, {} });
+}
+
+void SceneController::addLayer() {
+    layers.emplace_back();
+    currentLayer = static_cast<int>(layers.size()) - 1;
+    recorder.calls.push_back({ SceneCall::Kind::AddLayer, currentLayer, {}, 0, {} });
+}
+
+void SceneController::selectWithLine(const Line& line) {
+    selection.clear();
+    const auto& lines = layers[currentLayer];
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (line.bounds.intersects(lines[i].bounds)) {
+            selection.push_back(i);
+        }
+    }
+    recorder.calls.push_back({ SceneCall::Kind::SelectWithLine, currentLayer, line, selection.size(), {} });
+}
+
+QList<std::shared_ptr<SceneItem>> SceneController::cloneSelectedItems(int layer, double scale) {
+    Q_UNUSED(scale);
+
+    QList<std::shared_ptr<SceneItem>> items;
+    for (auto index : selection) {
+        auto item = std::make_shared<SceneLineItem>(
+            SceneLineItem::fromLine(Line(layers[layer][index])));
+        item->vtable = vtable;
+        items.append(item);
+    }
+    recorder.calls.push_back({ SceneCall::Kind::CloneSelectedItems, layer, {}, static_cast<size_t>(items.size()), {} });
+    return items;
+}
+
+void SceneController::deleteSelectedItems(int layer) {
+    auto& lines = layers[layer];
+    std::sort(selection.rbegin(), selection.rend());
+    for (auto index : selection) {
+        lines.erase(lines.begin() + index);
+    }
+    recorder.calls.push_back({ SceneCall::Kind::DeleteSelectedItems, layer, {}, selection.size(), {} });
+    selection.clear();
+}
+
+void SceneController::clearSelectedItems() {
+    selection.clear();
+    recorder.calls.push_back({ SceneCall::Kind::ClearSelectedItems, currentLayer, {}, 0, {} });
+}
+
+void TileManager::renderLineToTiles(const Line& line) {
+    recorder.calls.push_back({ SceneCall::Kind::RenderLineToTiles, -1, line, 1, {} });
+}
+
+void TileManager::reload() {
+    recorder.calls.push_back({ SceneCall::Kind::Reload, -1, {}, 0, {} });
+}
+
+void TileManager::reload(const QRectF& region) {
+    recorder.calls.push_back({ SceneCall::Kind::Reload, -1, {}, 0, region });
+}
+
+void Clipboard::setItems(QList<std::shared_ptr<SceneItem>> items) {
+    clipboardItems = std::move(items);
+    recorder.calls.push_back({ SceneCall::Kind::SetClipboardItems, -1, {}, static_cast<size_t>(clipboardItems.size()), {} });
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QRectF>
+#include <QString>
+#include <memory>
+#include <vector>
+#include "rm_Line.hpp"
+#include "rm_SceneItem.hpp"
+
+// Stand-ins for the parts of xochitl's QML scene API the plugin uses.
+// They do no rendering, they only record what they were asked to do.
+
+struct SceneCall {
+    enum class Kind {
+        SetLayerName,
+        AddDrawingLine,
+        AddLayer,
+        SelectWithLine,
+        CloneSelectedItems,
+        DeleteSelectedItems,
+        ClearSelectedItems,
+        RenderLineToTiles,
+        Reload,
+        SetClipboardItems,
+    };
+
+    Kind kind;
+    int layer;
+    // lines and item counts of the call, if any
+    Line line;
+    size_t itemCount;
+    // what a reload invalidated, null for the whole view
+    QRectF region;
+};
+
+struct SceneRecorder {
+    std::vector<SceneCall> calls;
+
+    size_t count(SceneCall::Kind kind) const;
+    void clear() { calls.clear(); }
+};
+
+class SceneController {
+public:
+    explicit SceneController(SceneRecorder& recorder) : recorder(recorder) {}
+
+    int currentLayer = 0;
+
+    void setLayerName(int layer, const QString& name);
+    void addDrawingLine(const Line& line);
+    void addLayer();
+
+    void selectWithLine(const Line& line);
+    QList<std::shared_ptr<SceneItem>> cloneSelectedItems(int layer, double scale);
+    void deleteSelectedItems(int layer);
+    void clearSelectedItems();
+
+    // every line drawn so far, per layer
+    std::vector<std::vector<Line>> layers = { {} };
+
+    // what cloned SceneLineItems carry as their vtable
+    static void* const vtable;
+
+private:
+    SceneRecorder& recorder;
+    std::vector<size_t> selection;
+};
+
+// A QObject like the real one, PuzzleManager finds its methods by name.
+class TileManager : public QObject {
+    Q_OBJECT
+public:
+    explicit TileManager(SceneRecorder& recorder) : recorder(recorder) {}
+
+    Q_INVOKABLE void renderLineToTiles(const Line& line);
+    Q_INVOKABLE void reload();
+    Q_INVOKABLE void reload(const QRectF& region);
+
+private:
+    SceneRecorder& recorder;
+};
+
+class Clipboard {
+public:
+    explicit Clipboard(SceneRecorder& recorder) : recorder(recorder) {}
+
+    void setItems(QList<std::shared_ptr<SceneItem>> items);
+    const QList<std::shared_ptr<SceneItem>>& items() const { return clipboardItems; }
+
+private:
+    SceneRecorder& recorder;
+    QList<std::shared_ptr<SceneItem>> clipboardItems;
+};
+
+struct MockScene {
+    SceneRecorder recorder;
+    SceneController sceneController { recorder };
+    TileManager tileManager { recorder };
+    Clipboard clipboard { recorder };
+};
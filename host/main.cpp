@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <QCoreApplication>
+#include "Flows.hpp"
+#include "GlyphCache.hpp"
+#include "PlayedSet.hpp"
+#include "PuzzleQueue.hpp"
+#include "StrokeRecorder.hpp"
+#include "rm_SceneLineItem.hpp"
+#include "vtable.h"
+
+using Kind = SceneCall::Kind;
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+static void checkDrawPuzzle(PuzzleManager& manager) {
+    for (int difficulty = 0; difficulty < 4; ++difficulty) {
+        MockScene scene;
+        Flows::drawPuzzle(manager, scene, difficulty);
+
+        const auto& calls = scene.recorder.calls;
+        const size_t lines = scene.recorder.count(Kind::AddDrawingLine);
+
+        // hints plus the grid, with 17 clues being the known minimum
+        expect(lines >= 18 && lines <= 82, "drawPuzzle draws the clues and the grid");
+        expect(scene.recorder.count(Kind::RenderLineToTiles) == lines, "every drawn line is rendered");
+        expect(calls.size() == 2 * lines + 3, "drawPuzzle makes no unexpected calls");
+        expect(!calls.empty() && calls.front().kind == Kind::SetLayerName, "layer is named first");
+        expect(calls.size() >= 2 && calls[calls.size() - 2].kind == Kind::Reload, "tiles are reloaded once at the end");
+
+        QRectF drawn;
+        for (const auto& line : scene.sceneController.layers[0]) {
+            drawn |= line.bounds;
+        }
+        expect(!drawn.isNull() && manager.sudokuBounds() == drawn, "the dirty region is the union of the lines");
+        expect(calls.size() >= 2 && calls[calls.size() - 2].region == drawn, "only the dirty region is reloaded");
+        expect(!calls.empty() && calls.back().kind == Kind::AddLayer, "a fresh layer is added last");
+        expect(scene.sceneController.layers[0].size() == lines, "lines land on the puzzle layer");
+        expect(!scene.sceneController.layers[0].empty()
+            && scene.sceneController.layers[0].back().points.size() == 40, "the grid is drawn last");
+    }
+}
+
+static void checkClipboard(PuzzleManager& manager) {
+    MockScene scene;
+    Flows::copyCrosshair(manager, scene);
+
+    expect(SceneLineItem::vtable_ptr == SceneController::vtable, "vtable is taken from the cloned item");
+    expect(scene.sceneController.layers[0].empty(), "the probe line is deleted again");
+    expect(scene.clipboard.items().size() == 6, "crosshair has six items");
+    for (const auto& item : scene.clipboard.items()) {
+        expect(item->vtable == SceneController::vtable, "clipboard items carry the vtable");
+    }
+
+    scene.recorder.clear();
+    Flows::copyStars(manager, scene);
+    expect(scene.recorder.count(Kind::CloneSelectedItems) == 0, "the vtable is only probed once");
+    expect(scene.clipboard.items().size() == 20, "twenty stars are copied");
+}
+
+static void checkCopyPuzzle(PuzzleManager& manager) {
+    for (int difficulty = 0; difficulty < 4; ++difficulty) {
+        MockScene scene;
+        Flows::copyPuzzle(manager, scene, difficulty);
+
+        const auto& items = scene.clipboard.items();
+        expect(items.size() >= 18 && items.size() <= 82, "the clues and the grid are copied");
+        expect(scene.recorder.count(Kind::SetClipboardItems) == 1, "the puzzle is one clipboard batch");
+        expect(scene.recorder.count(Kind::RenderLineToTiles) == 0, "copying renders nothing");
+
+        QRectF copied;
+        for (const auto& item : items) {
+            const auto* lineItem = static_cast<const SceneLineItem*>(item.get());
+            expect(lineItem->vtable == SceneController::vtable, "puzzle items carry the vtable");
+            copied |= lineItem->line.bounds;
+        }
+        expect(std::abs(copied.center().x()) < 1.0 && std::abs(copied.center().y()) < 1.0,
+            "the puzzle is centered on the paste position");
+    }
+}
+
+// Anything polymorphic of the host's own, with an out of line key function
+// so its vtable is emitted once, like xochitl's SceneLineItem.
+class VtableProbe {
+public:
+    virtual ~VtableProbe();
+    virtual int value() const;
+};
+
+VtableProbe::~VtableProbe() = default;
+int VtableProbe::value() const { return 1; }
+
+static void checkFindVtable() {
+    VtableProbe* probe = new VtableProbe();
+    void* vtable = *reinterpret_cast<void**>(probe);
+    delete probe;
+
+    expect(findVtable("11VtableProbe") == vtable, "the vtable is found in the image");
+    expect(findVtable("13SceneLineItem") == nullptr, "classes that aren't there aren't found");
+    expect(isVtableOf(vtable, "11VtableProbe"), "the vtable's typeinfo names its class");
+    expect(!isVtableOf(vtable, "13SceneLineItem"), "another class' vtable is turned down");
+    expect(!isVtableOf(&failures, "11VtableProbe"), "anything but a vtable is turned down");
+}
+
+static void checkPuzzleQueue() {
+    // easy never builds, and every build is slow enough that the queue is
+    // torn down while one is under way
+    std::atomic<int> easyBuilds = 0;
+    {
+        PuzzleQueue queue([&easyBuilds](Sudoku::Difficulty level) -> std::optional<PuzzleQueue::Puzzle> {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            if (level == Sudoku::Difficulty::Easy) {
+                ++easyBuilds;
+                return std::nullopt;
+            }
+            return PuzzleQueue::Puzzle{};
+        });
+        queue.start();
+
+        bool filled = false;
+        for (int i = 0; i < 100 && !filled; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            filled = queue.take(Sudoku::Difficulty::Expert).has_value();
+        }
+        expect(filled, "a failing difficulty doesn't keep the others from filling");
+    }
+    expect(easyBuilds > 0 && easyBuilds < 10, "a failing difficulty is retried with a delay");
+}
+
+static void checkStrokeRecorder() {
+    const char* path = "/tmp/sudoku-host-strokes.bin";
+    std::remove(path);
+
+    StrokeRecorder recorder;
+    expect(recorder.open(path), "a stroke recording opens");
+    Line line = {};
+    line.points.resize(3);
+    recorder.record(line);
+    recorder.record(line);
+
+    // written without closing, as a session that ends in a crash never does
+    bool written = false;
+    for (int i = 0; i < 40 && !written; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const auto strokes = StrokeRecorder::load(path);
+        written = strokes.has_value() && strokes->size() == 2;
+    }
+    expect(written, "recorded strokes reach the file before close");
+
+    recorder.record(line);
+    recorder.close();
+    const auto strokes = StrokeRecorder::load(path);
+    expect(strokes.has_value() && strokes->size() == 3, "close writes the rest");
+    std::remove(path);
+}
+
+static void checkPlayedSet() {
+    const char* path = "/tmp/sudoku-host-played.bin";
+    std::remove(path);
+
+    // an odd count, so the last word is partly past the end
+    constexpr const uint32_t Count = 4099;
+    std::vector<bool> seen(Count);
+    bool repeated = false;
+    {
+        PlayedSet played;
+        expect(played.open(path, Count, 1), "a played set opens");
+        for (uint32_t i = 0; i < Count - 1; ++i) {
+            const uint32_t index = played.take(i * 0x9E3779B97F4A7C15ull);
+            if (index >= Count || seen[index]) {
+                repeated = true;
+                continue;
+            }
+            seen[index] = true;
+        }
+    }
+
+    PlayedSet played;
+    expect(played.open(path, Count, 1) && played.played() == Count - 1, "played records are kept across opens");
+    const uint32_t last = played.take(12345);
+    repeated |= last >= Count || seen[last];
+    expect(!repeated, "nothing is picked twice until all is played");
+    played.take(0);
+    expect(played.played() == 1, "an exhausted set starts over");
+    expect(played.open(path, Count, 2) && played.played() == 0, "another pack starts over");
+    std::remove(path);
+}
+
+// usage: check
+static int check(PuzzleManager& manager) {
+    checkDrawPuzzle(manager);
+    checkClipboard(manager);
+    checkCopyPuzzle(manager);
+    checkFindVtable();
+    checkPuzzleQueue();
+    checkStrokeRecorder();
+    checkPlayedSet();
+
+    printf("%s\n", failures == 0 ? "All flows passed" : "Some flows failed");
+    return failures == 0 ? 0 : 1;
+}
+
+// usage: draw [inserts per difficulty] [ms between inserts]
+static int draw(PuzzleManager& manager, int argc, char** argv) {
+    const int count = argc > 0 ? std::atoi(argv[0]) : 100;
+    const int pause = argc > 1 ? std::atoi(argv[1]) : 0;
+
+    manager.setTracing(true);
+
+    for (int difficulty = 0; difficulty < 4; ++difficulty) {
+        double total = 0.0;
+        double worst = 0.0;
+        for (int i = 0; i < count; ++i) {
+            MockScene scene;
+            const auto start = std::chrono::steady_clock::now();
+            Flows::drawPuzzle(manager, scene, difficulty);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            total += seconds;
+            worst = std::max(worst, seconds);
+            std::this_thread::sleep_for(std::chrono::milliseconds(pause));
+        }
+        printf("difficulty %d: avg %8.3fms, worst %8.3fms per insert\n",
+            difficulty, total * 1000.0 / count, worst * 1000.0);
+    }
+
+    manager.logPrefetchStats();
+    manager.dumpTrace();
+    return 0;
+}
+
+// Waits for the stroke worker to finish and delivers its results.
+static void drainStrokes(PuzzleManager& manager) {
+    for (int i = 0; i < 10000 && manager.strokeQueueDepth() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    QCoreApplication::processEvents();
+}
+
+// Writes glyphs into the cells through the stroke hook, as fast as the
+// pen would allow, and reports how the stroke worker kept up.
+// usage: write [strokes] [ms between strokes] [recording]
+static int write(PuzzleManager& manager, int argc, char** argv) {
+    const int count = argc > 0 ? std::atoi(argv[0]) : 200;
+    const int pause = argc > 1 ? std::atoi(argv[1]) : 0;
+    if (argc > 2 && !manager.startRecording(QString(argv[2]))) {
+        return 1;
+    }
+
+    MockScene scene;
+    Flows::drawPuzzle(manager, scene, 0);
+
+    for (int i = 0; i < count; ++i) {
+        const QPointF center = manager.cellCenter(i % 9, i / 9 % 9);
+        manager.logLine(Line::fromPoints(GlyphCache::place(i % 9 + 1, center, 40.0f), center, 40.0f));
+        QCoreApplication::processEvents();
+        std::this_thread::sleep_for(std::chrono::milliseconds(pause));
+    }
+
+    drainStrokes(manager);
+    manager.stopRecording();
+    manager.logStrokeStats();
+    return 0;
+}
+
+// Feeds a recorded session back through the stroke hook, paced like it
+// was written, and prints every recognized digit as "column row digit".
+// A speed of 0 replays as fast as the worker keeps up. Recognition groups
+// strokes by when they arrive, so other speeds may group differently.
+// Given the output of an earlier run, reports where it differs.
+// usage: replay <recording> [speed] [expected]
+static int replay(PuzzleManager& manager, int argc, char** argv) {
+    if (argc < 1) {
+        printf("usage: replay <recording> [speed] [expected]\n");
+        return 1;
+    }
+    const double speed = argc > 1 ? std::atof(argv[1]) : 1.0;
+
+    auto strokes = StrokeRecorder::load(argv[0]);
+    if (!strokes.has_value()) {
+        return 1;
+    }
+
+    std::vector<std::string> results;
+    QObject::connect(&manager, &PuzzleManager::digitRecognized, [&](int column, int row, int digit) {
+        results.push_back(std::to_string(column) + " " + std::to_string(row) + " " + std::to_string(digit));
+        printf("%s\n", results.back().c_str());
+    });
+
+    manager.setTracing(true);
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t previous = strokes->empty() ? 0 : strokes->front().timestamp;
+    for (const auto& stroke : strokes.value()) {
+        // appended sessions start over at 0
+        if (speed > 0.0 && stroke.timestamp > previous) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(
+                static_cast<uint64_t>((stroke.timestamp - previous) / speed)));
+        }
+        previous = stroke.timestamp;
+
+        manager.logLine(stroke.line);
+        if (speed <= 0.0) {
+            drainStrokes(manager);
+        }
+        QCoreApplication::processEvents();
+    }
+    drainStrokes(manager);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Replayed %zu strokes in %.3fs\n", strokes->size(), seconds);
+    manager.logStrokeStats();
+    manager.dumpTrace();
+
+    if (argc < 3) {
+        return 0;
+    }
+
+    std::ifstream file(argv[2]);
+    std::vector<std::string> expected;
+    for (std::string line; std::getline(file, line);) {
+        // only result lines, the statistics change from run to run
+        int column, row, digit;
+        if (std::sscanf(line.c_str(), "%d %d %d", &column, &row, &digit) == 3 && line.find(':') == std::string::npos) {
+            expected.push_back(line);
+        }
+    }
+
+    size_t differences = 0;
+    for (size_t i = 0; i < std::max(expected.size(), results.size()); ++i) {
+        const std::string want = i < expected.size() ? expected[i] : "-";
+        const std::string got = i < results.size() ? results[i] : "-";
+        if (want != got) {
+            printf("result %zu: expected %s, got %s\n", i, want.c_str(), got.c_str());
+            ++differences;
+        }
+    }
+    printf("%s\n", differences == 0 ? "Replay matches" : "Replay differs");
+    return differences == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    PuzzleManager manager;
+
+    if (argc >= 2 && std::strcmp(argv[1], "check") == 0) {
+        return check(manager);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "draw") == 0) {
+        return draw(manager, argc - 2, argv + 2);
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "write") == 0) {
+        return write(manager, argc - 2, argv + 2);
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "replay") == 0) {
+        return replay(manager, argc - 2, argv + 2);
+    }
+
+    printf("Usage: %s check|draw|write|replay [args...]\n", argv[0]);
+    return 1;
+}
@@ -1,7 +1,28 @@
+#include <cstdio>
 #include <QQmlApplicationEngine>
 #include "PuzzleManager.hpp"
+#include "rm_SceneLineItem.hpp"
+#include "vtable.h"
 
 extern "C" void registerQmldiff() {
     qmlRegisterSingletonInstance<PuzzleManager>(
         "net.sudoku", 1, 0, "PuzzleManager", new PuzzleManager());
 }
+
+// Takes the vtable entry.c found, if its typeinfo really is SceneLineItem's
+// and items built with it look normal. A wrong vtable can still build items
+// that look normal, so the typeinfo is checked first. Otherwise sudoku.qmd
+// falls back to cloning an item drawn for the purpose.
+extern "C" void setupSceneLineItemVtable(void* vtable) {
+    if (!isVtableOf(vtable, "13SceneLineItem")) {
+        printf("SceneLineItem vtable %p doesn't name SceneLineItem, cloning one on first use\n", vtable);
+        return;
+    }
+    SceneLineItem::setupVtable(vtable);
+
+    const auto item = SceneLineItem::fromLine(Line{});
+    SceneLineItem::log(item);
+    if (!SceneLineItem::isNormal(item)) {
+        SceneLineItem::setupVtable(nullptr);
+    }
+}
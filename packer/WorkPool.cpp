@@ -0,0 +1,89 @@
+#include "WorkPool.hpp"
+
+// which pool and queue the current thread works for, if any
+static thread_local const WorkPool* currentPool = nullptr;
+static thread_local unsigned currentQueue = 0;
+
+WorkPool::WorkPool(unsigned threads) {
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkPool::run, this, i);
+    }
+}
+
+WorkPool::~WorkPool() {
+    wait();
+    stopping = true;
+    ++wakeups;
+    wakeups.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkPool::submit(Task task) {
+    const unsigned index = currentPool == this
+        ? currentQueue
+        : nextQueue++ % size();
+
+    ++pending;
+    {
+        std::lock_guard guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    ++wakeups;
+    wakeups.notify_one();
+}
+
+void WorkPool::wait() {
+    for (size_t left = pending; left != 0; left = pending) {
+        pending.wait(left);
+    }
+}
+
+std::optional<WorkPool::Task> WorkPool::take(unsigned index) {
+    {
+        Queue& own = *queues[index];
+        std::lock_guard guard(own.lock);
+        if (!own.tasks.empty()) {
+            Task task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return task;
+        }
+    }
+
+    for (unsigned offset = 1; offset < size(); ++offset) {
+        Queue& other = *queues[(index + offset) % size()];
+        std::lock_guard guard(other.lock);
+        if (!other.tasks.empty()) {
+            Task task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            ++stealCount;
+            return task;
+        }
+    }
+    return std::nullopt;
+}
+
+void WorkPool::run(unsigned index) {
+    currentPool = this;
+    currentQueue = index;
+
+    while (true) {
+        const uint32_t seen = wakeups.load(std::memory_order_acquire);
+        if (auto task = take(index)) {
+            (*task)();
+            if (--pending == 0) {
+                pending.notify_all();
+            }
+            continue;
+        }
+
+        if (stopping) {
+            return;
+        }
+        wakeups.wait(seen);
+    }
+}
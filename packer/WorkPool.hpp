@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Runs tasks on a fixed set of threads. Each thread works through its own
+// queue newest first, and once that runs dry takes the oldest task from
+// another thread's queue. Tasks submitted by a task go to the queue of the
+// thread running it, so follow-up work stays local unless someone is idle.
+class WorkPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkPool(unsigned threads);
+    // Waits for everything submitted.
+    ~WorkPool();
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    void submit(Task task);
+    // Blocks until every task has run, including ones submitted meanwhile.
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+    // Tasks run by a thread other than the one they were queued on.
+    size_t steals() const { return stealCount; }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void run(unsigned index);
+    std::optional<Task> take(unsigned index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    // submitted and not finished yet
+    std::atomic<size_t> pending = 0;
+    std::atomic<uint32_t> wakeups = 0;
+    std::atomic<bool> stopping = false;
+    std::atomic<size_t> stealCount = 0;
+    std::atomic<unsigned> nextQueue = 0;
+};
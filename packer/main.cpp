@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Canonical.hpp"
+#include "Generator.hpp"
+#include "Rater.hpp"
+#include "Solver.hpp"
+#include "WorkPool.hpp"
+
+constexpr const char* PackNames[] = { "easy", "medium", "hard", "expert" };
+constexpr const size_t RecordSize = 52;
+// seeds per task, small enough that the last tasks don't hold up the end
+constexpr const uint32_t BatchSize = 64;
+// filled grids dug per seed before it's given up, a count rather than a
+// deadline so the packs don't depend on how busy the machine is
+constexpr const int PuzzleGrids = 128;
+
+struct Record {
+    std::array<unsigned char, RecordSize> bytes;
+    uint8_t rating;
+    // of the canonical form, which equivalent puzzles share
+    uint64_t hash;
+    std::array<unsigned char, RecordSize> canonical;
+};
+
+struct Packs {
+    std::mutex lock;
+    std::array<std::vector<Record>, 4> records;
+    // canonical forms of the accepted puzzles, indexed by their hashes
+    CanonicalIndex index;
+    std::vector<std::array<unsigned char, RecordSize>> canonical;
+    size_t duplicates = 0;
+    size_t collisions = 0;
+    size_t overflow = 0;
+    // batches done ahead of an earlier one, by first seed; they are taken
+    // in seed order so the packs don't depend on thread timing
+    std::map<uint32_t, std::vector<std::pair<size_t, Record>>> pending;
+    uint32_t nextBatch;
+};
+
+struct Stats {
+    std::atomic<size_t> generated = 0;
+    std::atomic<size_t> missed = 0;
+    std::atomic<size_t> ambiguous = 0;
+    // per pack, read without the lock to stop early
+    std::array<std::atomic<size_t>, 4> accepted = {};
+};
+
+class Packer {
+public:
+    Packer(WorkPool& pool, size_t perPack, uint32_t seed)
+        : pool(pool), perPack(perPack), nextSeed(seed) {
+        packs.nextBatch = seed;
+    }
+
+    void start() {
+        for (unsigned i = 0; i < pool.size() * 4; ++i) {
+            submitBatch();
+        }
+        pool.wait();
+    }
+
+    Packs packs;
+    Stats stats;
+
+private:
+    bool full() const {
+        return std::all_of(stats.accepted.begin(), stats.accepted.end(),
+            [this](const auto& accepted) { return accepted >= perPack; });
+    }
+
+    // Seeds take turns between the packs, so what a seed generates doesn't
+    // depend on how full the packs happen to be.
+    static Sudoku::Difficulty levelOf(uint32_t seed) {
+        return static_cast<Sudoku::Difficulty>(seed % 4);
+    }
+
+    void submitBatch() {
+        pool.submit([this] { runBatch(); });
+    }
+
+    // The seeds are taken when the batch starts rather than when it's
+    // submitted: the pool runs the newest task first, and the first seeds
+    // have to be done before anything later can be taken.
+    void runBatch() {
+        if (full()) {
+            return;
+        }
+        const uint32_t first = nextSeed.fetch_add(BatchSize);
+
+        std::vector<std::pair<size_t, Record>> made;
+        for (uint32_t seed = first; seed < first + BatchSize; ++seed) {
+            const auto sudoku = Generator::generate(levelOf(seed), seed, PuzzleGrids);
+            if (!sudoku.has_value()) {
+                ++stats.missed;
+                continue;
+            }
+            ++stats.generated;
+
+            // the generator checks as it goes, this is the final word
+            const auto givens = Solver::givens(sudoku.value());
+            if (!Solver::hasUniqueSolution(givens)) {
+                ++stats.ambiguous;
+                continue;
+            }
+
+            const auto rating = Rater::rate(givens);
+            Record record = {};
+            record.rating = rating.rating;
+            sudoku->encode(record.bytes.data());
+            const auto canonical = Canonical::form(sudoku.value());
+            record.hash = Canonical::hash(canonical);
+            canonical.encode(record.canonical.data());
+            made.emplace_back(static_cast<size_t>(Rater::difficulty(rating)), record);
+        }
+
+        {
+            std::lock_guard guard(packs.lock);
+            packs.pending.emplace(first, std::move(made));
+            for (auto batch = packs.pending.find(packs.nextBatch); batch != packs.pending.end();
+                 batch = packs.pending.find(packs.nextBatch)) {
+                accept(batch->second);
+                packs.pending.erase(batch);
+                packs.nextBatch += BatchSize;
+            }
+        }
+
+        if (!full()) {
+            submitBatch();
+        }
+    }
+
+    // Holds the pack lock.
+    void accept(const std::vector<std::pair<size_t, Record>>& made) {
+        for (const auto& [pack, record] : made) {
+            if (packs.records[pack].size() >= perPack) {
+                ++packs.overflow;
+                continue;
+            }
+            // a relabelled, rotated or shuffled copy is the same puzzle
+            const auto first = packs.index.insert(record.hash, static_cast<uint32_t>(packs.canonical.size()));
+            if (first.has_value()) {
+                if (packs.canonical[first.value()] == record.canonical) {
+                    ++packs.duplicates;
+                    continue;
+                }
+                // kept, later copies of it just won't be caught
+                ++packs.collisions;
+            } else {
+                packs.canonical.push_back(record.canonical);
+            }
+            packs.records[pack].push_back(record);
+            stats.accepted[pack] = packs.records[pack].size();
+        }
+    }
+
+    WorkPool& pool;
+    const size_t perPack;
+    std::atomic<uint32_t> nextSeed;
+};
+
+static bool writePack(const std::string& path, std::vector<Record>& records, FILE* ratings, const char* name) {
+    // easiest first, the order SUDOKU01 wants its partitions in
+    std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.rating != b.rating ? a.rating < b.rating : a.bytes < b.bytes;
+    });
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        printf("Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(records.size());
+    const unsigned char header[12] = {
+        'S', 'U', 'D', 'O', 'K', 'U', '0', '0',
+        static_cast<unsigned char>(count), static_cast<unsigned char>(count >> 8),
+        static_cast<unsigned char>(count >> 16), static_cast<unsigned char>(count >> 24),
+    };
+    bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    for (const auto& record : records) {
+        written &= fwrite(record.bytes.data(), 1, RecordSize, file) == RecordSize;
+        if (ratings != nullptr) {
+            for (auto byte : record.bytes) {
+                fprintf(ratings, "%02x", byte);
+            }
+            fprintf(ratings, " %u %s\n", record.rating, name);
+        }
+    }
+    written &= fclose(file) == 0;
+    if (!written) {
+        printf("Failed to write %s\n", path.c_str());
+        return false;
+    }
+
+    // read back through the plugin's own decoder
+    if (Sudoku::countInFile(path.c_str()).value_or(0) != count) {
+        printf("%s doesn't read back\n", path.c_str());
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto sudoku = Sudoku::loadFromFile(path.c_str(), static_cast<int>(i));
+        std::array<unsigned char, RecordSize> decoded;
+        if (sudoku.has_value()) {
+            sudoku->encode(decoded.data());
+        }
+        if (!sudoku.has_value() || decoded != records[i].bytes) {
+            printf("%s record %u doesn't read back\n", path.c_str(), i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// usage: sudoku-packer <output directory> [puzzles per pack] [threads] [seed] [ratings file]
+// Writes easy.bin to expert.bin as SUDOKU00, the ratings file is what
+// sudoku-compress.py pack --ratings takes.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: %s <output directory> [puzzles per pack] [threads] [seed] [ratings file]\n", argv[0]);
+        return 1;
+    }
+    const std::string directory = argv[1];
+    const size_t perPack = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    // 0 for one per core
+    const unsigned requested = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 0;
+    const unsigned threads = requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t seed = argc > 4 ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 1;
+
+    const auto start = std::chrono::steady_clock::now();
+    WorkPool pool(threads);
+    Packer packer(pool, perPack, seed);
+    packer.start();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE* ratings = nullptr;
+    if (argc > 5 && (ratings = fopen(argv[5], "w")) == nullptr) {
+        printf("Failed to open %s\n", argv[5]);
+        return 1;
+    }
+
+    bool ok = true;
+    for (size_t pack = 0; pack < 4; ++pack) {
+        const std::string path = directory + "/" + PackNames[pack] + ".bin";
+        ok &= writePack(path, packer.packs.records[pack], ratings, PackNames[pack]);
+        printf("%-6s %zu puzzles -> %s\n", PackNames[pack], packer.packs.records[pack].size(), path.c_str());
+    }
+    if (ratings != nullptr) {
+        fclose(ratings);
+    }
+
+    const size_t generated = packer.stats.generated;
+    printf("%zu generated in %.1fs on %u threads, %.0f puzzles/s\n",
+        generated, seconds, threads, generated / seconds);
+    printf("%zu given up, %zu ambiguous, %zu duplicates, %zu hash collisions, %zu beyond a full pack, %zu steals\n",
+        packer.stats.missed.load(), packer.stats.ambiguous.load(),
+        packer.packs.duplicates, packer.packs.collisions, packer.packs.overflow, pool.steals());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+# Builds puzzle packs natively, generating, checking, rating and
+# deduplicating by canonical form on every core, e.g.
+#   qmake6 && make && ./sudoku-packer ../res 1000000
+TEMPLATE = app
+TARGET = sudoku-packer
+CONFIG += console c++20
+CONFIG -= app_bundle
+
+OBJECTS_DIR = build/obj
+MOC_DIR = build/moc
+
+QT = core
+
+SOURCES += \
+    main.cpp WorkPool.cpp \
+    ../BlockPack.cpp ../Canonical.cpp ../Generator.cpp ../PlayedSet.cpp ../Rater.cpp ../Solver.cpp ../Sudoku.cpp ../Tracer.cpp
+
+HEADERS += WorkPool.hpp
+INCLUDEPATH += ..
+
+QMAKE_CXXFLAGS += -O2 -Werror
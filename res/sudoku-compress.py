@@ -1,8 +1,13 @@
 import json
 import struct
 import sys
+import zlib
 from typing import List, Dict
 
+DIFFICULTIES = ['easy', 'medium', 'hard', 'expert']
+METADATA_SIZE = 8
+RATING_INDEX_SIZE = 257 * 4
+
 
 def compress_sudoku(puzzle_str: str, solution_str: str) -> bytes:
     """
@@ -144,12 +149,178 @@ def decompress_binary_file(input_file: str, output_file: str):
     print(f"Decompressed {len(puzzles)} puzzles to {output_file}")
 
 
+def read_records(input_file: str) -> List[bytes]:
+    """
+    Read the raw 52 byte records of a SUDOKU00 file.
+    """
+    with open(input_file, 'rb') as f:
+        data = f.read()
+    if data[0:8] != b'SUDOKU00':
+        raise ValueError(f"Invalid file format. Expected 'SUDOKU00', got {data[0:8]}")
+    count = struct.unpack('<I', data[8:12])[0]
+    return [data[12 + i * 52:12 + (i + 1) * 52] for i in range(count)]
+
+
+def record_clues(record: bytes) -> int:
+    return sum(bin(b).count('1') for b in record[41:52])
+
+
+def read_ratings(input_file: str) -> Dict[bytes, tuple]:
+    """
+    Read the output of `sudoku-bench rate`: one "<record hex> <rating> <difficulty>" per line.
+    """
+    ratings = {}
+    with open(input_file, 'r') as f:
+        for line in f:
+            record, rating, difficulty = line.split()
+            ratings[bytes.fromhex(record)] = (int(rating), difficulty)
+    return ratings
+
+
+class BitWriter:
+    """
+    Little endian bit stream, padded to a byte when done.
+    """
+    def __init__(self):
+        self.out = bytearray()
+        self.buffer = 0
+        self.available = 0
+
+    def write(self, value: int, bits: int):
+        self.buffer |= value << self.available
+        self.available += bits
+        while self.available >= 8:
+            self.out.append(self.buffer & 0xFF)
+            self.buffer >>= 8
+            self.available -= 8
+
+    def finish(self) -> bytes:
+        if self.available:
+            self.out.append(self.buffer & 0xFF)
+        return bytes(self.out)
+
+
+def write_choice(writer: BitWriter, value: int, choices: int):
+    """
+    Truncated binary, the extra bit of the long codes goes last.
+    """
+    if choices < 2:
+        return
+    bits = choices.bit_length() - 1
+    shorter = (2 << bits) - choices
+    if value < shorter:
+        writer.write(value, bits)
+    else:
+        writer.write((value + shorter) >> 1, bits)
+        writer.write((value + shorter) & 1, 1)
+
+
+def compress_block(records: List[bytes]) -> bytes:
+    """
+    One SUDOKU02 block, see BlockPack.hpp: each solution digit as its index
+    among the digits still allowed in its row, column and box, then the mask.
+    """
+    writer = BitWriter()
+    for record in records:
+        rows, columns, boxes = [0] * 9, [0] * 9, [0] * 9
+        for cell in range(81):
+            digit = record[cell // 2] >> 4 if cell % 2 == 0 else record[cell // 2] & 0x0F
+            row, column = divmod(cell, 9)
+            box = row // 3 * 3 + column // 3
+            allowed = 0x3FE & ~(rows[row] | columns[column] | boxes[box])
+            if not allowed >> digit & 1:
+                raise ValueError(f"Not a solved grid: {record.hex()}")
+            write_choice(writer, bin(allowed & ((1 << digit) - 1)).count('1'), bin(allowed).count('1'))
+            rows[row] |= 1 << digit
+            columns[column] |= 1 << digit
+            boxes[box] |= 1 << digit
+        for cell in range(81):
+            writer.write(record[41 + cell // 8] >> (cell % 8) & 1, 1)
+    return writer.finish()
+
+
+def pack_files(output_file: str, partitions: Dict[str, List[bytes]], ratings: Dict[bytes, int] = None,
+               per_block: int = 0):
+    """
+    Write SUDOKU01 with one partition per difficulty, see README.md, or
+    SUDOKU02 with the records compressed in blocks of `per_block`.
+
+    Records are sorted by rating within their partition so the rating index
+    can point at contiguous ranges.
+    """
+    ratings = ratings or {}
+    parts = []
+    records = bytearray()
+    metadata = bytearray()
+    rating_indices = bytearray()
+    first = 0
+
+    for name, partition in partitions.items():
+        partition = sorted(partition, key=lambda r: ratings.get(r, 0))
+        part_metadata = b''.join(
+            struct.pack('<BBHI', ratings.get(r, 0), record_clues(r), 0, 0) for r in partition)
+
+        rating_index = []
+        for rating in range(257):
+            rating_index.append(sum(1 for r in partition if ratings.get(r, 0) < rating))
+        part_rating_index = struct.pack('<257I', *rating_index)
+
+        parts.append((name, first, len(partition), part_metadata, part_rating_index))
+        records += b''.join(partition)
+        metadata += part_metadata
+        rating_indices += part_rating_index
+        first += len(partition)
+
+    checksums = b''
+    if per_block:
+        offsets = [0]
+        blocks = bytearray()
+        block_crcs = []
+        for start in range(0, first, per_block):
+            block = compress_block([records[i:i + 52] for i in range(start * 52, min(start + per_block, first) * 52, 52)])
+            block_crcs.append(zlib.crc32(block))
+            blocks += block
+            offsets.append(len(blocks))
+        checksums = struct.pack(f'<{len(block_crcs)}I', *block_crcs)
+
+    toc = []
+    for name, part_first, part_count, part_metadata, part_rating_index in parts:
+        if per_block:
+            # the checksums of the blocks holding the partition, each block
+            # is only checked once it's decoded
+            first_block = part_first // per_block
+            end_block = (part_first + part_count + per_block - 1) // per_block
+            crc = zlib.crc32(checksums[first_block * 4:end_block * 4])
+        else:
+            crc = zlib.crc32(records[part_first * 52:(part_first + part_count) * 52])
+        crc = zlib.crc32(part_metadata, crc)
+        crc = zlib.crc32(part_rating_index, crc)
+        toc.append(struct.pack('<B3xIII', DIFFICULTIES.index(name), part_first, part_count, crc))
+
+    if per_block:
+        records = struct.pack(f'<{len(offsets)}I', *offsets) + checksums + blocks
+
+    magic = b'SUDOKU02' if per_block else b'SUDOKU01'
+    header = magic + struct.pack('<IBBH', first, len(toc), 1, per_block)
+    table = b''.join(toc)
+    with open(output_file, 'wb') as f:
+        f.write(header)
+        f.write(struct.pack('<I', zlib.crc32(table, zlib.crc32(header))))
+        f.write(table)
+        f.write(records)
+        f.write(metadata)
+        f.write(rating_indices)
+
+    print(f"Packed {first} puzzles in {len(toc)} partitions, {len(records)} bytes of records")
+
+
 if __name__ == '__main__':
     if len(sys.argv) < 2:
         print("Usage:")
         print("  Compress:   python compress.py compress <input.json> <output.bin>")
         print("  Decompress: python compress.py decompress <input.bin> <output.json>")
         print("  Test:       python compress.py test <input.json>")
+        print("  Pack:       python compress.py pack <output.bin> <difficulty>=<input.bin>... [--ratings <ratings.txt>] [--block <records>]")
         sys.exit(1)
     
     command = sys.argv[1]
@@ -204,6 +375,44 @@ if __name__ == '__main__':
         print(f"  Compressed size: {compressed_size:,} bytes")
         print(f"  Compression ratio: {ratio:.1f}%")
     
+    elif command == 'pack':
+        args = sys.argv[2:]
+        rated = None
+        if '--ratings' in args:
+            at = args.index('--ratings')
+            rated = read_ratings(args[at + 1])
+            del args[at:at + 2]
+        per_block = 0
+        if '--block' in args:
+            at = args.index('--block')
+            per_block = int(args[at + 1])
+            del args[at:at + 2]
+            if not 0 < per_block < 65536:
+                print("Records per block must be 1 to 65535")
+                sys.exit(1)
+        if len(args) < 2:
+            print("Usage: python compress.py pack <output.bin> <difficulty>=<input.bin>... [--ratings <ratings.txt>] [--block <records>]")
+            sys.exit(1)
+        partitions = {}
+        for arg in args[1:]:
+            name, path = arg.split('=', 1)
+            if name not in DIFFICULTIES:
+                print(f"Unknown difficulty: {name}")
+                sys.exit(1)
+            partitions[name] = read_records(path)
+
+        ratings = None
+        if rated is not None:
+            # the rater decides where a puzzle goes, not the input it came from
+            records = [r for partition in partitions.values() for r in partition]
+            missing = [r for r in records if r not in rated]
+            if missing:
+                print(f"{len(missing)} puzzles have no rating")
+                sys.exit(1)
+            partitions = {name: [r for r in records if rated[r][1] == name] for name in DIFFICULTIES}
+            ratings = {r: rated[r][0] for r in records}
+        pack_files(args[0], partitions, ratings, per_block)
+
     else:
         print(f"Unknown command: {command}")
         sys.exit(1)
@@ -18,7 +18,7 @@ Line Line::fromPoints(QList<LinePoint> &&points, const QRectF& bounds) {
     line.tool = 0x13; // SolidPen
     line.color = 0; // Black
     line.rgba = 0xff000000;
-    line.points = QList(points.begin(), points.end());
+    line.points = std::move(points);
     line.maskScale = 1.0;
     line.thickness = 0.0f;
     line.bounds = bounds;
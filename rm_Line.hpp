@@ -35,7 +35,8 @@ struct Line {
 };
 #ifdef __arm__
 static_assert(sizeof(Line) == 0x48);
-#elifdef __aarch64__
+#elif defined(__aarch64__) || defined(__x86_64__)
+// x86_64 for host builds, LP64 like aarch64
 static_assert(sizeof(Line) == 0x58);
 #else
 #error "Unknown Arch"
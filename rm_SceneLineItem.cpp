@@ -9,11 +9,9 @@ void SceneLineItem::setupVtable(void* vtable) {
     SceneLineItem::vtable_ptr = vtable;
 }
 
-void SceneLineItem::log(const SceneLineItem& item) {
-    printf("  Id: %d, Source Layer: %d\n", item.pageIndex, item.sourceLayerId);
-
+bool SceneLineItem::isNormal(const SceneLineItem& item) {
     bool unusual = false;
-    unusual |= item.vtable != vtable_ptr;
+    unusual |= item.vtable == nullptr;
     unusual |= item.unk_x4 != 3;
     unusual |= item.pageIndex < 0xE;
     unusual |= item.unk_xc != 0;
@@ -33,8 +31,13 @@ void SceneLineItem::log(const SceneLineItem& item) {
     for (auto v : item.unk_x7c) {
         unusual |= v != 0;
     }
+    return !unusual;
+}
+
+void SceneLineItem::log(const SceneLineItem& item) {
+    printf("  Id: %d, Source Layer: %d\n", item.pageIndex, item.sourceLayerId);
 
-    if (!unusual) {
+    if (item.vtable == vtable_ptr && isNormal(item)) {
         printf("Normal clipboard item\n");
         return;
     }
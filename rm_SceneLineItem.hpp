@@ -30,11 +30,13 @@ struct SceneLineItem : public SceneItem {
         item.pageIndex = 0xE;
         item.unk_xe = 1;
         item.sourceLayerId = 0xB;
-        item.line = line;
+        item.line = std::move(line);
         item.unk_x78 = 1;
         return item;
     }
 
+    // Whether the fields of `item` look like those of xochitl's items.
+    static bool isNormal(const SceneLineItem& item);
     static void log(const SceneLineItem& item);
 };
 #ifdef __arm__
@@ -42,7 +44,7 @@ static_assert(offsetof(SceneLineItem, unk_x20) == 0x20);
 static_assert(offsetof(SceneLineItem, line) == 0x30);
 static_assert(offsetof(SceneLineItem, unk_x78) == 0x78);
 static_assert(sizeof(SceneLineItem) == 0x88);
-#elifdef __aarch64__
+#elif defined(__aarch64__) || defined(__x86_64__)
 static_assert(offsetof(SceneLineItem, unk_x20) == 0x28);
 static_assert(offsetof(SceneLineItem, line) == 0x48);
 static_assert(offsetof(SceneLineItem, unk_x78) == 0xa0);
@@ -3,6 +3,7 @@ TEMPLATE = lib
 TARGET = sudoku
 CONFIG += shared plugin no_plugin_name_prefix
 QMAKE_LFLAGS += -Wl,--no-undefined
+LIBS += -ldl
 
 # Configure build directories
 OBJECTS_DIR = build/obj
@@ -26,11 +27,11 @@ CONFIG += c++20
 
 # Specify the source files
 SOURCES += \
-    main.cpp entry.c $$XOVI_DIR/xovi.c \
-    PuzzleManager.cpp Sudoku.cpp \
-    rm_Line.cpp rm_SceneLineItem.cpp
+    main.cpp entry.c vtable.c $$XOVI_DIR/xovi.c \
+    BlockPack.cpp PlayedSet.cpp PuzzleManager.cpp PuzzleQueue.cpp Sudoku.cpp Solver.cpp Generator.cpp Rater.cpp \
+    BoardState.cpp GlyphCache.cpp Recognizer.cpp SceneItemPool.cpp StrokePipeline.cpp StrokeRecorder.cpp Tessellation.cpp Tracer.cpp rm_Line.cpp rm_SceneLineItem.cpp
 
-HEADERS += PuzzleManager.hpp Sudoku.hpp
+HEADERS += BlockPack.hpp BoardState.hpp Crc32.hpp GlyphCache.hpp PlayedSet.hpp PuzzleManager.hpp PuzzleQueue.hpp Recognizer.hpp SceneItemPool.hpp StrokePipeline.hpp StrokeRecorder.hpp Sudoku.hpp Solver.hpp Generator.hpp Rater.hpp Tessellation.hpp Tracer.hpp vtable.h
 INCLUDEPATH += $$XOVI_DIR
 
 QMAKE_CXXFLAGS += -fPIC -Werror -Wno-invalid-offsetof
@@ -0,0 +1,175 @@
+#define _GNU_SOURCE
+#include "vtable.h"
+
+#include <dlfcn.h>
+#include <link.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_SEGMENTS 16
+// more references than this to a typeinfo name are not worth sorting out
+#define MAX_CANDIDATES 8
+
+struct Segment {
+    uintptr_t start;
+    uintptr_t end;
+    int executable;
+};
+
+struct Image {
+    struct Segment segments[MAX_SEGMENTS];
+    int count;
+};
+
+static int collectMainImage(struct dl_phdr_info* info, size_t size, void* data) {
+    (void)size;
+    struct Image* image = data;
+
+    for (int i = 0; i < info->dlpi_phnum && image->count < MAX_SEGMENTS; ++i) {
+        const ElfW(Phdr)* header = &info->dlpi_phdr[i];
+        if (header->p_type != PT_LOAD || !(header->p_flags & PF_R)) {
+            continue;
+        }
+
+        struct Segment* segment = &image->segments[image->count++];
+        segment->start = info->dlpi_addr + header->p_vaddr;
+        segment->end = segment->start + header->p_memsz;
+        segment->executable = (header->p_flags & PF_X) != 0;
+    }
+
+    // the main executable is always reported first
+    return 1;
+}
+
+static const struct Segment* segmentOf(const struct Image* image, uintptr_t address) {
+    for (int i = 0; i < image->count; ++i) {
+        if (address >= image->segments[i].start && address < image->segments[i].end) {
+            return &image->segments[i];
+        }
+    }
+    return NULL;
+}
+
+// A vtable pointer points at the first virtual function, past the
+// offset to top and the typeinfo.
+static int isVtable(const struct Image* image, const uintptr_t* vtable) {
+    const struct Segment* segment = segmentOf(image, (uintptr_t)vtable);
+    if (segment == NULL || segment->executable
+        || (uintptr_t)(vtable - 2) < segment->start
+        || (uintptr_t)(vtable + 1) > segment->end) {
+        return 0;
+    }
+
+    const struct Segment* function = segmentOf(image, vtable[0]);
+    return vtable[-2] == 0 && function != NULL && function->executable;
+}
+
+// The typeinfo a vtable refers to names `mangledName`, which nothing
+// about the items built with it can tell.
+static int namesClass(const struct Image* image, const uintptr_t* vtable, const char* mangledName) {
+    const struct Segment* segment = segmentOf(image, (uintptr_t)(vtable - 1));
+    if (segment == NULL || (uintptr_t)vtable > segment->end) {
+        return 0;
+    }
+
+    const uintptr_t* typeinfo = (const uintptr_t*)vtable[-1];
+    segment = segmentOf(image, (uintptr_t)typeinfo);
+    if (segment == NULL || (uintptr_t)(typeinfo + 2) > segment->end) {
+        return 0;
+    }
+
+    const char* name = (const char*)typeinfo[1];
+    const size_t length = strlen(mangledName) + 1;
+    segment = segmentOf(image, (uintptr_t)name);
+    return segment != NULL && (uintptr_t)name + length <= segment->end
+        && memcmp(name, mangledName, length) == 0;
+}
+
+// Pointer aligned words equal to `value`, returns how many there are.
+static int findWords(const struct Image* image, uintptr_t value, const uintptr_t** found, int max) {
+    int count = 0;
+    for (int i = 0; i < image->count; ++i) {
+        const struct Segment* segment = &image->segments[i];
+        const uintptr_t* word = (const uintptr_t*)((segment->start + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1));
+        const uintptr_t* end = (const uintptr_t*)(segment->end & ~(sizeof(uintptr_t) - 1));
+        for (; word < end; ++word) {
+            if (*word != value) {
+                continue;
+            }
+            if (count < max) {
+                found[count] = word;
+            }
+            ++count;
+        }
+    }
+    return count;
+}
+
+// type_info is { vtable, name }, and the class' vtable is
+// { offset to top, typeinfo, functions... }.
+static void* scanImage(const struct Image* image, const char* mangledName) {
+    const size_t length = strlen(mangledName) + 1;
+    const uintptr_t* result = NULL;
+    int results = 0;
+
+    for (int i = 0; i < image->count; ++i) {
+        const struct Segment* segment = &image->segments[i];
+        const char* start = (const char*)segment->start;
+        const char* end = (const char*)segment->end;
+
+        for (const char* name = memmem(start, end - start, mangledName, length);
+             name != NULL;
+             name = memmem(name + 1, end - name - 1, mangledName, length)) {
+            // the whole string, not the tail of a nested name
+            if (name != start && name[-1] != '\0') {
+                continue;
+            }
+
+            const uintptr_t* names[MAX_CANDIDATES];
+            const int nameCount = findWords(image, (uintptr_t)name, names, MAX_CANDIDATES);
+            for (int n = 0; n < nameCount && n < MAX_CANDIDATES; ++n) {
+                const uintptr_t* typeinfo = names[n] - 1;
+
+                const uintptr_t* references[MAX_CANDIDATES];
+                const int referenceCount = findWords(image, (uintptr_t)typeinfo, references, MAX_CANDIDATES);
+                for (int r = 0; r < referenceCount && r < MAX_CANDIDATES; ++r) {
+                    const uintptr_t* vtable = references[r] + 1;
+                    if (isVtable(image, vtable) && vtable != result) {
+                        result = vtable;
+                        ++results;
+                    }
+                }
+            }
+        }
+    }
+
+    if (results > 1) {
+        printf("findVtable: %d candidates for %s\n", results, mangledName);
+        return NULL;
+    }
+    return (void*)result;
+}
+
+void* findVtable(const char* mangledName) {
+    struct Image image = {0};
+    dl_iterate_phdr(collectMainImage, &image);
+
+    char symbol[256];
+    snprintf(symbol, sizeof(symbol), "_ZTV%s", mangledName);
+    const uintptr_t* exported = dlsym(RTLD_DEFAULT, symbol);
+    if (exported != NULL && isVtable(&image, exported + 2) && namesClass(&image, exported + 2, mangledName)) {
+        return (void*)(exported + 2);
+    }
+
+    return scanImage(&image, mangledName);
+}
+
+int isVtableOf(const void* vtable, const char* mangledName) {
+    struct Image image = {0};
+    dl_iterate_phdr(collectMainImage, &image);
+
+    return vtable != NULL
+        && isVtable(&image, vtable)
+        && namesClass(&image, vtable, mangledName);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The vtable pointer objects of a class in the main executable carry,
+// e.g. "13SceneLineItem" for SceneLineItem. Looked up as a dynamic symbol
+// first, then by scanning the loaded image for the class' typeinfo and
+// the vtable referring to it. NULL if it can't be found unambiguously.
+void* findVtable(const char* mangledName);
+
+// Whether `vtable` is one in the main executable whose typeinfo names
+// `mangledName`.
+int isVtableOf(const void* vtable, const char* mangledName);
+
+#ifdef __cplusplus
+}
+#endif